@@ -0,0 +1,150 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// Minimal Arduino API for building the firmware without the Arduino core.
+// Only what main.cpp and MD_MAX72XX use. Pins, clock and serial are
+// implemented in arduinoHost.cpp for the host ([env:native], see
+// hostRuntime.h) and in idf/arduinoIdf.cpp for the ESP-IDF build.
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#define PROGMEM
+#define F(s) (s)
+#define HIGH 1
+#define LOW 0
+#define OUTPUT 1
+#define INPUT 0
+#define MSBFIRST 1
+#define LSBFIRST 0
+#define HEX 16
+#define DEC 10
+#define BIN 2
+
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define bitWrite(value, bit, bitvalue) ((bitvalue) ? bitSet(value, bit) : bitClear(value, bit))
+#define pgm_read_byte(addr) (*(const unsigned char *)(addr))
+#define pgm_read_word(addr) (*(const unsigned short *)(addr))
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+using std::min;
+using std::max;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+void shiftOut(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t val);
+
+class String {
+ public:
+  String(const char *s = "") : s_(s ? s : "") {}
+  String(const std::string &s) : s_(s) {}
+  String(char c) : s_(1, c) {}
+  String(int v) : s_(std::to_string(v)) {}
+  String(unsigned v) : s_(std::to_string(v)) {}
+  String(long v) : s_(std::to_string(v)) {}
+  String(unsigned long v) : s_(std::to_string(v)) {}
+
+  unsigned int length() const { return s_.size(); }
+  const char *c_str() const { return s_.c_str(); }
+  char operator[](unsigned i) const { return i < s_.size() ? s_[i] : 0; }
+  char &operator[](unsigned i) { return s_[i]; }
+  char charAt(unsigned i) const { return (*this)[i]; }
+
+  void trim() {
+    size_t a = s_.find_first_not_of(" \t\r\n");
+    if (a == std::string::npos) { s_.clear(); return; }
+    size_t b = s_.find_last_not_of(" \t\r\n");
+    s_ = s_.substr(a, b - a + 1);
+  }
+  void toUpperCase() { for (auto &c : s_) c = toupper((unsigned char)c); }
+  bool startsWith(const String &p) const { return s_.compare(0, p.s_.size(), p.s_) == 0; }
+  bool endsWith(const String &p) const {
+    return s_.size() >= p.s_.size() && s_.compare(s_.size() - p.s_.size(), p.s_.size(), p.s_) == 0;
+  }
+  String substring(unsigned a) const { return a >= s_.size() ? String() : String(s_.substr(a)); }
+  String substring(unsigned a, unsigned b) const {
+    if (a > b) std::swap(a, b);
+    if (a >= s_.size()) return String();
+    return String(s_.substr(a, b - a));
+  }
+  int indexOf(char c, unsigned from = 0) const { return pos(s_.find(c, from)); }
+  int indexOf(const String &t, unsigned from = 0) const { return pos(s_.find(t.s_, from)); }
+  int lastIndexOf(char c) const { return pos(s_.rfind(c)); }
+  long toInt() const { return strtol(s_.c_str(), nullptr, 10); }
+  void remove(unsigned i, unsigned n) { if (i < s_.size()) s_.erase(i, n); }
+  void remove(unsigned i) { if (i < s_.size()) s_.erase(i); }
+  bool reserve(unsigned n) { s_.reserve(n); return true; }
+
+  String &operator+=(const String &o) { s_ += o.s_; return *this; }
+  String &operator+=(char c) { s_ += c; return *this; }
+  String &operator+=(const char *c) { s_ += c; return *this; }
+  friend String operator+(String a, const String &b) { a += b; return a; }
+  bool operator==(const String &o) const { return s_ == o.s_; }
+  bool operator==(const char *o) const { return s_ == o; }
+  bool operator!=(const String &o) const { return s_ != o.s_; }
+  bool operator!=(const char *o) const { return s_ != o; }
+  bool equals(const String &o) const { return s_ == o.s_; }
+
+ private:
+  static int pos(size_t p) { return p == std::string::npos ? -1 : (int)p; }
+  std::string s_;
+};
+
+// Host: stdin/stdout or whatever hostRuntime.h plugs in. IDF: USB Serial/JTAG.
+class HardwareSerial {
+ public:
+  void begin(unsigned long baud);
+  int available();
+  int read();
+  int availableForWrite();
+  size_t write(uint8_t c) { return write(&c, 1); }
+  size_t write(const uint8_t *b, size_t n);
+  size_t print(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+  size_t print(const String &s) { return print(s.c_str()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(long v, int base = DEC) { return printNumber(v < 0, v < 0 ? -(unsigned long)v : v, base); }
+  size_t print(unsigned long v, int base = DEC) { return printNumber(false, v, base); }
+  size_t print(int v, int base = DEC) { return print((long)v, base); }
+  size_t print(unsigned v, int base = DEC) { return print((unsigned long)v, base); }
+  size_t print(unsigned char v, int base = DEC) { return print((unsigned long)v, base); }
+  size_t print(double v, int digits = 2) {
+    char b[40];
+    snprintf(b, sizeof b, "%.*f", digits, v);
+    return print(b);
+  }
+  template <typename T> size_t println(T v) { size_t n = print(v); return n + println(); }
+  template <typename T> size_t println(T v, int b) { size_t n = print(v, b); return n + println(); }
+  size_t println() { return print("\r\n"); }
+  void flush() {}
+  explicit operator bool() const { return true; }
+
+ private:
+  size_t printNumber(bool negative, unsigned long v, int base) {
+    char b[40];
+    snprintf(b, sizeof b, base == HEX ? "%s%lX" : "%s%lu", negative ? "-" : "", v);
+    return print(b);
+  }
+};
+
+extern HardwareSerial Serial;
+
+#endif // HOST_ARDUINO_H
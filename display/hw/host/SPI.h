@@ -0,0 +1,27 @@
+#ifndef HOST_SPI_H
+#define HOST_SPI_H
+
+// Hardware SPI for the shim builds; bytes go to the MAX7219 emulator (host)
+// or to the panel's SPI transaction (idf/).
+
+#include <Arduino.h>
+
+#define SPI_MODE0 0
+
+struct SPISettings {
+  SPISettings() {}
+  SPISettings(uint32_t, uint8_t, uint8_t) {}
+};
+
+class SPIClass {
+ public:
+  void begin() {}
+  void end() {}
+  void beginTransaction(SPISettings) {}
+  void endTransaction() {}
+  uint8_t transfer(uint8_t b);
+};
+
+extern SPIClass SPI;
+
+#endif // HOST_SPI_H
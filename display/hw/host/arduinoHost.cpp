@@ -0,0 +1,108 @@
+#include <Arduino.h>
+#include <SPI.h>
+#include "hostRuntime.h"
+
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <thread>
+
+HardwareSerial Serial;
+SPIClass SPI;
+
+// --- CLOCK -----------------------------------------------------------------
+static bool virtualClock = false;
+static uint64_t virtualUs = 0;
+static const auto startTime = std::chrono::steady_clock::now();
+
+void hostUseVirtualClock(bool on) { virtualClock = on; }
+bool hostVirtualClock() { return virtualClock; }
+void hostAdvance(unsigned long ms) { virtualUs += (uint64_t)ms * 1000; }
+
+uint64_t hostMicros() {
+  if (virtualClock) return virtualUs;
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - startTime).count();
+}
+
+unsigned long millis() { return (unsigned long)(hostMicros() / 1000); }
+unsigned long micros() { return (unsigned long)hostMicros(); }
+
+void delay(unsigned long ms) {
+  if (virtualClock) hostAdvance(ms);
+  else std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(unsigned int us) {
+  if (virtualClock) virtualUs += us;
+}
+
+// Fixed sequence so virtual-clock runs are identical
+static uint32_t rngState = 1;
+void randomSeed(unsigned long seed) { rngState = seed ? seed : 1; }
+long random(long max) {
+  rngState = rngState * 1103515245u + 12345u;
+  return max > 0 ? (long)((rngState >> 8) % (uint32_t)max) : 0;
+}
+long random(long min, long max) { return max > min ? min + random(max - min) : min; }
+
+// --- SERIAL ----------------------------------------------------------------
+static std::deque<char> serialIn;
+static std::function<void(const uint8_t *, size_t)> serialOut =
+    [](const uint8_t *b, size_t n) { fwrite(b, 1, n, stdout); fflush(stdout); };
+
+void hostSerialFeed(const char *data, size_t len) { serialIn.insert(serialIn.end(), data, data + len); }
+size_t hostSerialPending() { return serialIn.size(); }
+void hostSerialOutput(std::function<void(const uint8_t *, size_t)> sink) { serialOut = std::move(sink); }
+
+void HardwareSerial::begin(unsigned long) {}
+int HardwareSerial::available() { return (int)serialIn.size(); }
+int HardwareSerial::availableForWrite() { return 4096; }
+
+int HardwareSerial::read() {
+  if (serialIn.empty()) return -1;
+  char c = serialIn.front();
+  serialIn.pop_front();
+  return (uint8_t)c;
+}
+
+size_t HardwareSerial::write(const uint8_t *b, size_t n) {
+  if (serialOut) serialOut(b, n);
+  return n;
+}
+
+// --- PINS / PANEL ----------------------------------------------------------
+static std::unique_ptr<Max7219Chain> panel;
+static uint8_t panelData = 0xFF, panelClk = 0xFF, panelCs = 0xFF;
+
+Max7219Chain &hostAttachPanel(uint8_t devices, uint8_t dataPin, uint8_t clkPin, uint8_t csPin) {
+  panel.reset(new Max7219Chain(devices));
+  panelData = dataPin;
+  panelClk = clkPin;
+  panelCs = csPin;
+  return *panel;
+}
+
+Max7219Chain *hostPanel() { return panel.get(); }
+
+void pinMode(uint8_t, uint8_t) {}
+int digitalRead(uint8_t) { return LOW; }
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  if (panel && pin == panelCs) panel->select(val == LOW);
+}
+
+void shiftOut(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t val) {
+  if (!panel || dataPin != panelData || clockPin != panelClk) return;
+  if (bitOrder == LSBFIRST) {
+    uint8_t r = 0;
+    for (uint8_t i = 0; i < 8; i++) r |= ((val >> i) & 1) << (7 - i);
+    val = r;
+  }
+  panel->clockByte(val);
+}
+
+uint8_t SPIClass::transfer(uint8_t b) {
+  if (panel) panel->clockByte(b);
+  return 0;
+}
@@ -0,0 +1,365 @@
+// Host entry point for the native build (pio run -e native): runs the
+// firmware's setup()/loop() against the emulated MAX7219 chain.
+//
+//   .pio/build/native/program [options] < commands.txt
+//
+//   --virtual      virtual clock: 1 ms per loop() without sleeping, so the
+//                  output is identical every run
+//   --for <ms>     keep running this long after stdin is closed (default 1000)
+//   --frames       print the panel to stderr every time a latch changes it
+//   --panel        print the final panel to stderr
+//   --stats        print SPI byte counters to stderr
+//   --verify       after every loop(), check the panel matches mx's buffer
+//                  with the overlays on top
+//   --events <f>   append "FRAME <us> <image>" to f on every panel change; us
+//                  is the virtual clock, or CLOCK_MONOTONIC in real time, the
+//                  image is 32 column bytes in hex (bit 0 = top row). With
+//                  --pty also "READ <us> <n>" before every loop() that reads
+//                  serial input, n = bytes read in total once it has, so
+//                  frames can be matched to the command that caused them
+//   --replay <f>   feed a command capture ("<ms> <command>" lines, see
+//                  CommandCapture in src/display_controller.py) at its
+//                  timestamps instead of reading stdin; implies --virtual, so
+//                  the same log always produces the same frames
+//   --pty          serial goes over a pseudo-terminal instead of stdin/stdout,
+//                  so DisplayController can open it like the real port. The
+//                  slave path is printed as "PTY <path>". stdin then carries
+//                  control lines; with --virtual time moves on "RUN <ms>",
+//                  answered with "NOW <us>", and while serial input is in
+//                  flight: bytes arrive at 115200 8N1 and the firmware loops
+//                  1 ms at a time until it has read them. Exits when stdin
+//                  closes.
+//   --raster-bench [n]  check MD_MAX72XX's raster calls (fillRect, drawLine,
+//                  blit, ...) against setPoint() loops and time both, n
+//                  rounds (default 2000); runs nothing else
+//   --task-bench [n]  print every pattern coroutine's frame size and time
+//                  patternScheduler.tick() over n ticks (default 1000000);
+//                  runs nothing else
+//
+// The panel is reconstructed from the emulated registers, not from
+// MD_MAX72XX's buffer, so it shows what the SPI stream actually produced.
+
+#include <Arduino.h>
+#include <MD_MAX72xx.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <chrono>
+#include <deque>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "displayConfig.h"
+#include "hostRuntime.h"
+#include "overlay.h"
+
+extern MD_MAX72XX mx;
+void setup();
+void loop();
+
+constexpr int PANEL_WIDTH = MAX_DEVICES * 8;
+
+// FC16 modules as wired in displayConfig.h: device 0 holds x 0..7,
+// digit register 7 is the top row, segment bit n is column n
+static bool panelPixel(const Max7219Chain &p, int x, int y) {
+  return p.lit(x / 8, 7 - y, x % 8);
+}
+
+static void printPanel(const Max7219Chain &p, FILE *out) {
+  for (int y = 0; y < 8; y++) {
+    for (int x = 0; x < PANEL_WIDTH; x++) fputc(panelPixel(p, x, y) ? '#' : '.', out);
+    fputc('\n', out);
+  }
+}
+
+static void printStats(const Max7219Chain &p, FILE *out) {
+  const Max7219Chain::Stats &s = p.stats();
+  auto pct = [&](uint32_t n) { return s.bytes ? 100.0 * n / s.bytes : 0.0; };
+  fprintf(out, "SPI bytes      %u in %u frames\n", s.bytes, s.frames);
+  fprintf(out, "  useful       %u (%.1f%%)\n", s.usefulBytes(), pct(s.usefulBytes()));
+  fprintf(out, "  NOOP padding %u (%.1f%%)\n", s.noopBytes, pct(s.noopBytes));
+  fprintf(out, "  redundant    %u (%.1f%%)\n", s.redundantBytes, pct(s.redundantBytes));
+  fprintf(out, "digit writes   %u, control writes %u\n", s.digitWrites, s.controlWrites);
+  fprintf(out, "image changes  %u\n", s.imageChanges);
+  if (s.badFrames || s.deselectedBytes) {
+    fprintf(out, "PROTOCOL ERRORS: %u bad frames, %u bytes with CS high\n", s.badFrames, s.deselectedBytes);
+  }
+}
+
+static uint64_t eventClock() {
+  if (hostVirtualClock()) return hostMicros();
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Reads what is there without blocking; false once fd is closed
+static bool pump(int fd) {
+  char buf[512];
+  ssize_t n;
+  while ((n = read(fd, buf, sizeof(buf))) > 0) hostSerialFeed(buf, n);
+  if (n == 0) return false;
+  return errno == EAGAIN || errno == EWOULDBLOCK || errno == EIO;  // EIO: pty slave not open
+}
+
+static void setNonBlocking(int fd) { fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK); }
+
+static int openPty() {
+  int fd = posix_openpt(O_RDWR | O_NOCTTY);
+  if (fd < 0 || grantpt(fd) != 0 || unlockpt(fd) != 0) return -1;
+  termios t;
+  tcgetattr(fd, &t);
+  cfmakeraw(&t);
+  tcsetattr(fd, TCSANOW, &t);
+  setNonBlocking(fd);
+  return fd;
+}
+
+struct Options {
+  bool frames = false, panel = false, stats = false, verify = false, pty = false;
+  unsigned long runFor = 1000;
+  const char *events = nullptr;
+  const char *replay = nullptr;
+  FILE *eventFile = nullptr;          // opened from events
+};
+
+static uint32_t mismatches = 0;
+
+static void step(const Options &o, const Max7219Chain &panel) {
+  loop();
+  if (!o.verify) return;
+  for (int x = 0; x < PANEL_WIDTH; x++) {
+    for (int y = 0; y < 8; y++) {
+      if (panelPixel(panel, x, y) != (bool)(frameColumn(x) & (1 << (7 - y)))) mismatches++;
+    }
+  }
+}
+
+// stdin -> Serial, Serial -> stdout
+static void runStdio(const Options &o, const Max7219Chain &panel) {
+  bool open = true;
+  if (hostVirtualClock()) {
+    while (pump(STDIN_FILENO)) {}     // blocking reads: take everything first
+    open = false;
+  } else {
+    setNonBlocking(STDIN_FILENO);
+  }
+  setup();
+
+  unsigned long closedAt = millis();
+  for (;;) {
+    if (open && !pump(STDIN_FILENO)) {
+      open = false;
+      closedAt = millis();
+    }
+    step(o, panel);
+    if (!open && millis() - closedAt >= o.runFor) break;
+    if (hostVirtualClock()) hostAdvance(1);
+    else std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+// Capture log -> Serial at the logged times, Serial -> stdout
+static int runReplay(const Options &o, const Max7219Chain &panel) {
+  FILE *f = fopen(o.replay, "r");
+  if (!f) {
+    perror(o.replay);
+    return 1;
+  }
+  std::vector<std::pair<unsigned long, std::string>> log;
+  char line[512];                    // longest: ASSET DATA chunks
+  while (fgets(line, sizeof(line), f)) {
+    char *cmd;
+    unsigned long ms = strtoul(line, &cmd, 10);
+    if (line[0] == '#' || cmd == line || *cmd != ' ') continue;
+    log.emplace_back(ms, cmd + 1);    // keeps the newline
+  }
+  fclose(f);
+
+  setup();
+  unsigned long start = millis();
+  unsigned long end = (log.empty() ? 0 : log.back().first) + o.runFor;
+  size_t next = 0;
+  for (;;) {
+    unsigned long t = millis() - start;
+    for (; next < log.size() && log[next].first <= t; next++) {
+      hostSerialFeed(log[next].second.data(), log[next].second.size());
+    }
+    step(o, panel);
+    if (t >= end) break;
+    hostAdvance(1);
+  }
+  return 0;
+}
+
+// Serial over a pty, control lines on stdin
+constexpr uint64_t SERIAL_BYTE_US = 87;   // 10 bits at 115200 baud
+
+static int runPty(const Options &o, const Max7219Chain &panel) {
+  int master = openPty();
+  if (master < 0) {
+    perror("pty");
+    return 1;
+  }
+  printf("PTY %s\n", ptsname(master));
+  fflush(stdout);
+  hostSerialOutput([master](const uint8_t *b, size_t n) {
+    while (n) {
+      ssize_t w = write(master, b, n);
+      if (w <= 0) {
+        if (errno == EAGAIN) { std::this_thread::yield(); continue; }
+        return;                       // nobody listening
+      }
+      b += w;
+      n -= w;
+    }
+  });
+  setup();
+
+  // Virtual: bytes from the pty wait in `wire` until their transfer time has
+  // passed. Real: they go to Serial as soon as they are read.
+  std::deque<char> wire;
+  uint64_t wireUs = 0;                // when the next byte on the wire is in
+  uint64_t fed = 0;                   // bytes handed to Serial so far
+  auto receive = [&] {
+    char buf[512];
+    ssize_t n;
+    while ((n = read(master, buf, sizeof(buf))) > 0) {
+      if (!hostVirtualClock()) {
+        hostSerialFeed(buf, n);
+        fed += n;
+        continue;
+      }
+      if (wire.empty()) wireUs = hostMicros() + SERIAL_BYTE_US;
+      wire.insert(wire.end(), buf, buf + n);
+    }
+  };
+  auto deliver = [&] {
+    for (; !wire.empty() && wireUs <= hostMicros(); wireUs += SERIAL_BYTE_US, fed++) {
+      hostSerialFeed(&wire.front(), 1);
+      wire.pop_front();
+    }
+  };
+  auto tick = [&] {
+    if (o.eventFile && hostSerialPending()) {
+      fprintf(o.eventFile, "READ %llu %llu\n", (unsigned long long)eventClock(), (unsigned long long)fed);
+      fflush(o.eventFile);
+    }
+    step(o, panel);
+  };
+
+  char line[64];
+  size_t len = 0;
+  for (;;) {
+    bool inFlight = hostVirtualClock() && (!wire.empty() || hostSerialPending());
+    pollfd fds[2] = { { STDIN_FILENO, POLLIN, 0 }, { master, POLLIN, 0 } };
+    poll(fds, 2, inFlight ? 0 : hostVirtualClock() ? -1 : 1);
+
+    if (fds[1].revents & POLLIN) receive();
+    if (fds[1].revents & POLLHUP) std::this_thread::sleep_for(std::chrono::milliseconds(1));  // no client yet
+
+    if (fds[0].revents & (POLLIN | POLLHUP)) {
+      char c;
+      ssize_t n = read(STDIN_FILENO, &c, 1);
+      if (n <= 0) break;
+      if (c != '\n') {
+        if (len < sizeof(line) - 1) line[len++] = c;
+      } else {
+        line[len] = 0;
+        len = 0;
+        unsigned long ms;
+        if (hostVirtualClock() && sscanf(line, "RUN %lu", &ms) == 1) {
+          for (unsigned long i = 0; i < ms; i++) {
+            receive();
+            deliver();
+            tick();
+            hostAdvance(1);
+          }
+          printf("NOW %llu\n", (unsigned long long)hostMicros());
+          fflush(stdout);
+        }
+      }
+    }
+
+    // Virtual: time runs while serial input is in flight.
+    // Real: the firmware just keeps looping.
+    if (!hostVirtualClock()) {
+      tick();
+    } else if (!wire.empty() || hostSerialPending()) {
+      deliver();
+      tick();
+      hostAdvance(1);
+    }
+  }
+  close(master);
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  Options o;
+  for (int i = 1; i < argc; i++) {
+    String a = argv[i];
+    if (a == "--virtual") hostUseVirtualClock(true);
+    else if (a == "--frames") o.frames = true;
+    else if (a == "--panel") o.panel = true;
+    else if (a == "--stats") o.stats = true;
+    else if (a == "--verify") o.verify = true;
+    else if (a == "--pty") o.pty = true;
+    else if (a == "--for" && i + 1 < argc) o.runFor = strtoul(argv[++i], nullptr, 10);
+    else if (a == "--events" && i + 1 < argc) o.events = argv[++i];
+    else if (a == "--raster-bench") {
+      unsigned n = i + 1 < argc ? strtoul(argv[i + 1], nullptr, 10) : 0;
+      return runRasterBench(n ? n : 2000);
+    }
+    else if (a == "--task-bench") {
+      unsigned n = i + 1 < argc ? strtoul(argv[i + 1], nullptr, 10) : 0;
+      return runTaskBench(n ? n : 1000000);
+    }
+    else if (a == "--replay" && i + 1 < argc) {
+      o.replay = argv[++i];
+      hostUseVirtualClock(true);
+    }
+    else {
+      fprintf(stderr, "usage: %s [--virtual] [--for ms] [--frames] [--panel] [--stats] [--verify] "
+                      "[--events file] [--pty | --replay file] [--raster-bench [n]] [--task-bench [n]]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  Max7219Chain &panel = hostAttachPanel(MAX_DEVICES, DATA_PIN, CLK_PIN, CS_PIN);
+  FILE *events = o.events ? fopen(o.events, "a") : nullptr;
+  if (o.events && !events) {
+    perror(o.events);
+    return 1;
+  }
+  o.eventFile = events;
+  panel.onImageChange = [&o, &panel, events] {
+    if (events) {
+      fprintf(events, "FRAME %llu ", (unsigned long long)eventClock());
+      for (int x = 0; x < PANEL_WIDTH; x++) {
+        uint8_t col = 0;
+        for (int y = 0; y < 8; y++) col |= panelPixel(panel, x, y) << y;
+        fprintf(events, "%02X", col);
+      }
+      fputc('\n', events);
+      fflush(events);
+    }
+    if (o.frames) {
+      fprintf(stderr, "FRAME %lu\n", millis());
+      printPanel(panel, stderr);
+    }
+  };
+
+  int rc = 0;
+  if (o.replay) rc = runReplay(o, panel);
+  else if (o.pty) rc = runPty(o, panel);
+  else runStdio(o, panel);
+
+  if (o.panel) printPanel(panel, stderr);
+  if (o.stats) printStats(panel, stderr);
+  if (o.verify) fprintf(stderr, "verify: %u pixel mismatches\n", mismatches);
+  if (events) fclose(events);
+  return rc ? rc : (o.verify && mismatches ? 1 : 0);
+}
@@ -0,0 +1,39 @@
+#ifndef HOST_RUNTIME_H
+#define HOST_RUNTIME_H
+
+// Host-only controls for the native build: clock, serial plumbing and the
+// emulated panel. The firmware itself never includes this.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+#include "max7219Emu.h"
+
+// --- CLOCK -----------------------------------------------------------------
+// Real time by default. With the virtual clock, millis() only moves when
+// hostAdvance() or delay() is called, so runs are exactly repeatable.
+void hostUseVirtualClock(bool on);
+bool hostVirtualClock();
+void hostAdvance(unsigned long ms);
+uint64_t hostMicros();             // same clock as micros(), without wrap
+
+// --- SERIAL ----------------------------------------------------------------
+void hostSerialFeed(const char *data, size_t len);   // queue bytes for Serial.read()
+size_t hostSerialPending();
+// Everything the firmware prints; default writes to stdout
+void hostSerialOutput(std::function<void(const uint8_t *, size_t)> sink);
+
+// --- PANEL -----------------------------------------------------------------
+// Chain wired to the given pins (bit-bang) or to SPI + csPin (hardware SPI)
+Max7219Chain &hostAttachPanel(uint8_t devices, uint8_t dataPin, uint8_t clkPin, uint8_t csPin);
+Max7219Chain *hostPanel();
+
+// --- BENCHMARKS ------------------------------------------------------------
+// MD_MAX72XX raster primitives vs setPoint() loops (rasterBench.cpp); checks
+// they draw the same, prints timings, returns nonzero on a mismatch
+int runRasterBench(unsigned iterations);
+// Coroutine frame sizes and scheduler tick()/resume cost (taskBench.cpp);
+// returns nonzero if a frame doesn't fit TASK_FRAME_SIZE
+int runTaskBench(unsigned ticks);
+
+#endif // HOST_RUNTIME_H
@@ -0,0 +1,87 @@
+#include "max7219Emu.h"
+
+// Code B font for digits in decode mode: D7 = DP, D6..D0 = segments A..G
+static const uint8_t CODE_B[16] = {
+  0x7E, 0x30, 0x6D, 0x79, 0x33, 0x5B, 0x5F, 0x70,   // 0-7
+  0x7F, 0x7B, 0x01, 0x4F, 0x37, 0x0E, 0x67, 0x00,   // 8 9 - E H L P blank
+};
+
+Max7219Chain::Max7219Chain(uint8_t devices) : dev_(devices) {}
+
+void Max7219Chain::select(bool csLow) {
+  if (selected_ && !csLow) latch();
+  if (csLow && !selected_) frameBytes_ = 0;
+  selected_ = csLow;
+}
+
+void Max7219Chain::clockByte(uint8_t b) {
+  stats_.bytes++;
+  if (!selected_) stats_.deselectedBytes++;
+  frameBytes_++;
+
+  // Device 0 takes the new byte, its top byte moves on down the chain
+  uint8_t in = b;
+  for (Device &d : dev_) {
+    uint8_t out = d.shift >> 8;
+    d.shift = (uint16_t)(d.shift << 8) | in;
+    in = out;
+  }
+}
+
+uint8_t Max7219Chain::segments(uint8_t d, uint8_t digit) const {
+  const Device &dv = dev_[d];
+  if (dv.displayTest & 1) return 0xFF;
+  if (!(dv.shutdown & 1)) return 0;
+  if (digit > (dv.scanLimit & 7)) return 0;
+  uint8_t v = dv.digit[digit];
+  if (dv.decodeMode & (1 << digit)) return (v & 0x80) | CODE_B[v & 0x0F];
+  return v;
+}
+
+void Max7219Chain::write(uint8_t &reg, uint8_t value, bool digit) {
+  if (reg == value) {
+    stats_.redundantBytes += 2;
+    return;
+  }
+  reg = value;
+  if (digit) stats_.digitWrites++;
+  else stats_.controlWrites++;
+}
+
+void Max7219Chain::latch() {
+  stats_.frames++;
+  if (frameBytes_ != 2 * dev_.size()) stats_.badFrames++;
+
+  uint8_t n = deviceCount();
+  std::vector<uint8_t> before(n * 8);
+  for (uint8_t d = 0; d < n; d++) {
+    for (uint8_t r = 0; r < 8; r++) before[d * 8 + r] = segments(d, r);
+  }
+
+  for (Device &d : dev_) {
+    uint8_t op = (d.shift >> 8) & 0x0F;   // D15..D12 are don't care
+    uint8_t data = d.shift & 0xFF;
+    switch (op) {
+      case OP_NOOP:        stats_.noopBytes += 2; break;
+      case OP_DECODEMODE:  write(d.decodeMode, data, false); break;
+      case OP_INTENSITY:   write(d.intensity, data & 0x0F, false); break;
+      case OP_SCANLIMIT:   write(d.scanLimit, data & 0x07, false); break;
+      case OP_SHUTDOWN:    write(d.shutdown, data & 0x01, false); break;
+      case OP_DISPLAYTEST: write(d.displayTest, data & 0x01, false); break;
+      default:
+        if (op >= OP_DIGIT0 && op <= OP_DIGIT7) write(d.digit[op - OP_DIGIT0], data, true);
+        else stats_.noopBytes += 2;       // 0x0D, 0x0E: unused, ignored by the part
+        break;
+    }
+  }
+
+  for (uint8_t d = 0; d < n; d++) {
+    for (uint8_t r = 0; r < 8; r++) {
+      if (before[d * 8 + r] != segments(d, r)) {
+        stats_.imageChanges++;
+        if (onImageChange) onImageChange();
+        return;
+      }
+    }
+  }
+}
@@ -0,0 +1,80 @@
+#ifndef MAX7219_EMU_H
+#define MAX7219_EMU_H
+
+// Register-level emulator of a daisy chain of MAX7219s, for the host build.
+//
+// Fed with the raw byte stream and CS edges the firmware produces (shiftOut,
+// SPI.transfer and digitalWrite on the CS pin are routed here by
+// arduinoHost.cpp). Each device is a 16-bit shift register; bytes enter
+// device 0 (the one wired to DIN) and fall out of its top into device 1, and
+// so on. On the rising edge of CS every device latches what is in its shift
+// register, exactly like LOAD on the real part.
+//
+// Besides the register file and the visible image this keeps counters of
+// what every byte on the bus was good for, so SPI-reduction work can be
+// measured: NOOP padding, writes that left a register unchanged, and short
+// or overlong frames.
+
+#include <stdint.h>
+#include <functional>
+#include <vector>
+
+class Max7219Chain {
+ public:
+  enum Opcode : uint8_t {
+    OP_NOOP = 0, OP_DIGIT0 = 1, OP_DIGIT7 = 8, OP_DECODEMODE = 9,
+    OP_INTENSITY = 10, OP_SCANLIMIT = 11, OP_SHUTDOWN = 12, OP_DISPLAYTEST = 15
+  };
+
+  struct Device {
+    uint16_t shift = 0;
+    uint8_t digit[8] = {};
+    uint8_t decodeMode = 0;
+    uint8_t intensity = 0;
+    uint8_t scanLimit = 0;
+    uint8_t shutdown = 0;        // bit 0: 0 = shut down (power-on state), 1 = normal
+    uint8_t displayTest = 0;     // bit 0: all LEDs on
+  };
+
+  struct Stats {
+    uint32_t bytes = 0;          // every byte clocked in
+    uint32_t frames = 0;         // CS rising edges
+    uint32_t noopBytes = 0;      // latched OP_NOOP words (padding for other devices)
+    uint32_t redundantBytes = 0; // register writes that did not change the register
+    uint32_t digitWrites = 0;    // effective OP_DIGITn writes
+    uint32_t controlWrites = 0;  // effective writes to the control registers
+    uint32_t badFrames = 0;      // latched with a byte count != 2 * devices
+    uint32_t deselectedBytes = 0;// clocked while CS was high
+    uint32_t imageChanges = 0;   // latches that changed a visible LED
+
+    uint32_t usefulBytes() const { return bytes - noopBytes - redundantBytes; }
+  };
+
+  explicit Max7219Chain(uint8_t devices);
+
+  // Bus side
+  void select(bool csLow);      // CS level; rising edge latches
+  void clockByte(uint8_t b);    // 8 clocks, MSB first
+
+  // Inspection
+  uint8_t deviceCount() const { return (uint8_t)dev_.size(); }
+  const Device &device(uint8_t d) const { return dev_[d]; }
+  uint8_t segments(uint8_t d, uint8_t digit) const;   // what the LEDs of a digit show
+  bool lit(uint8_t d, uint8_t digit, uint8_t seg) const { return segments(d, digit) & (1 << seg); }
+  const Stats &stats() const { return stats_; }
+  void resetStats() { stats_ = Stats(); }
+
+  // Called after every latch that changed the visible image
+  std::function<void()> onImageChange;
+
+ private:
+  void latch();
+  void write(uint8_t &reg, uint8_t value, bool digit);
+
+  std::vector<Device> dev_;
+  Stats stats_;
+  bool selected_ = false;
+  uint32_t frameBytes_ = 0;
+};
+
+#endif // MAX7219_EMU_H
@@ -0,0 +1,192 @@
+// Raster primitives vs setPoint() loops (hostMain --raster-bench).
+//
+// First checks that every raster call leaves exactly the same buffer as the
+// equivalent setPoint() loop, for random shapes and every wiring variant, and
+// that getDigits() snapshots read and write back like the buffer, then times
+// the raster calls against setPoint() on the panel's module type. Nothing is sent to the emulated
+// panel: the benchmark chains sit on unused pins with updates off.
+
+#include <Arduino.h>
+#include <MD_MAX72xx.h>
+#include "displayConfig.h"
+#include "hostRuntime.h"
+
+#include <chrono>
+
+namespace {
+
+constexpr uint8_t BENCH_DATA = 60, BENCH_CLK = 61, BENCH_CS = 62;  // not wired
+constexpr int16_t COLS = MAX_DEVICES * 8;
+
+struct Shape {
+  enum Kind { RECT, OUTLINE, HSPAN, VSPAN, LINE, BLIT, BLIT_MASKED } kind;
+  int16_t r1, c1, r2, c2;
+  bool state;
+  uint8_t data[12], mask[12];
+  uint8_t width;
+};
+
+const char *KIND_NAMES[] = { "fillRect", "drawRect", "setHSpan", "setVSpan", "drawLine", "blit", "blit+mask" };
+
+uint32_t rng = 12345;
+int16_t rnd(int16_t lo, int16_t hi) {
+  rng = rng * 1103515245u + 12345u;
+  return lo + (int16_t)((rng >> 8) % (uint32_t)(hi - lo + 1));
+}
+
+Shape randomShape(Shape::Kind kind) {
+  Shape s{};
+  s.kind = kind;
+  s.r1 = rnd(-2, 9);
+  s.r2 = rnd(-2, 9);
+  s.c1 = rnd(-4, COLS + 3);
+  s.c2 = rnd(-4, COLS + 3);
+  s.state = rnd(0, 3) != 0;
+  s.width = rnd(1, 12);
+  for (uint8_t i = 0; i < s.width; i++) {
+    s.data[i] = rnd(0, 255);
+    s.mask[i] = rnd(0, 255);
+  }
+  return s;
+}
+
+// --- setPoint() reference --------------------------------------------------
+void pointRect(MD_MAX72XX &m, int16_t r1, int16_t c1, int16_t r2, int16_t c2, bool state) {
+  if (r1 > r2) std::swap(r1, r2);
+  if (c1 > c2) std::swap(c1, c2);
+  for (int16_t r = r1; r <= r2; r++)
+    for (int16_t c = c1; c <= c2; c++)
+      if (r >= 0 && r < 8 && c >= 0 && c < COLS) m.setPoint(r, c, state);
+}
+
+void pointLine(MD_MAX72XX &m, int16_t r1, int16_t c1, int16_t r2, int16_t c2, bool state) {
+  int16_t dc = abs(c2 - c1), dr = -abs(r2 - r1);
+  int16_t sc = c1 < c2 ? 1 : -1, sr = r1 < r2 ? 1 : -1;
+  int16_t err = dc + dr;
+  for (;;) {
+    if (r1 >= 0 && r1 < 8 && c1 >= 0 && c1 < COLS) m.setPoint(r1, c1, state);
+    if (r1 == r2 && c1 == c2) break;
+    int16_t e2 = 2 * err;
+    if (e2 >= dr) { err += dr; c1 += sc; }
+    if (e2 <= dc) { err += dc; r1 += sr; }
+  }
+}
+
+void pointBlit(MD_MAX72XX &m, int16_t c, const uint8_t *data, uint8_t width, const uint8_t *mask) {
+  for (uint8_t i = 0; i < width; i++) {
+    if (c + i < 0 || c + i >= COLS) continue;
+    for (uint8_t r = 0; r < 8; r++) {
+      if (mask && !(mask[i] & (1 << r))) continue;
+      m.setPoint(r, c + i, data[i] & (1 << r));
+    }
+  }
+}
+
+void drawPoints(MD_MAX72XX &m, const Shape &s) {
+  switch (s.kind) {
+    case Shape::RECT:    pointRect(m, s.r1, s.c1, s.r2, s.c2, s.state); break;
+    case Shape::OUTLINE:
+      pointRect(m, s.r1, s.c1, s.r1, s.c2, s.state);
+      pointRect(m, s.r2, s.c1, s.r2, s.c2, s.state);
+      pointRect(m, s.r1, s.c1, s.r2, s.c1, s.state);
+      pointRect(m, s.r1, s.c2, s.r2, s.c2, s.state);
+      break;
+    case Shape::HSPAN:   pointRect(m, s.r1, s.c1, s.r1, s.c2, s.state); break;
+    case Shape::VSPAN:   pointRect(m, s.r1, s.c1, s.r2, s.c1, s.state); break;
+    case Shape::LINE:    pointLine(m, s.r1, s.c1, s.r2, s.c2, s.state); break;
+    case Shape::BLIT:    pointBlit(m, s.c1, s.data, s.width, nullptr); break;
+    case Shape::BLIT_MASKED: pointBlit(m, s.c1, s.data, s.width, s.mask); break;
+  }
+}
+
+void drawRaster(MD_MAX72XX &m, const Shape &s) {
+  switch (s.kind) {
+    case Shape::RECT:    m.fillRect(s.r1, s.c1, s.r2, s.c2, s.state); break;
+    case Shape::OUTLINE: m.drawRect(s.r1, s.c1, s.r2, s.c2, s.state); break;
+    case Shape::HSPAN:   m.setHSpan(s.r1, s.c1, s.c2, s.state); break;
+    case Shape::VSPAN:   m.setVSpan(s.c1, s.r1, s.r2, s.state); break;
+    case Shape::LINE:    m.drawLine(s.r1, s.c1, s.r2, s.c2, s.state); break;
+    case Shape::BLIT:    m.blit(s.c1, s.data, s.width); break;
+    case Shape::BLIT_MASKED: m.blit(s.c1, s.data, s.width, s.mask); break;
+  }
+}
+
+bool sameBuffer(MD_MAX72XX &a, MD_MAX72XX &b) {
+  for (int16_t c = 0; c < COLS; c++)
+    if (a.getColumn(c) != b.getColumn(c)) return false;
+  return true;
+}
+
+void startChain(MD_MAX72XX &m) {
+  m.begin();
+  m.control(MD_MAX72XX::UPDATE, MD_MAX72XX::OFF);
+}
+
+}  // namespace
+
+int runRasterBench(unsigned iterations) {
+  static const MD_MAX72XX::moduleType_t TYPES[] = {
+    MD_MAX72XX::FC16_HW, MD_MAX72XX::PAROLA_HW, MD_MAX72XX::GENERIC_HW, MD_MAX72XX::ICSTATION_HW,
+    MD_MAX72XX::DR0CR0RR1_HW, MD_MAX72XX::DR1CR0RR1_HW,
+  };
+  constexpr int KINDS = sizeof(KIND_NAMES) / sizeof(KIND_NAMES[0]);
+
+  // Same buffer as setPoint(), starting from random content
+  int mismatches = 0, digitMismatches = 0;
+  for (auto type : TYPES) {
+    MD_MAX72XX ref(type, BENCH_DATA, BENCH_CLK, BENCH_CS, MAX_DEVICES);
+    MD_MAX72XX ras(type, BENCH_DATA, BENCH_CLK, BENCH_CS, MAX_DEVICES);
+    startChain(ref);
+    startChain(ras);
+    for (int16_t c = 0; c < COLS; c++) {
+      uint8_t v = rnd(0, 255);
+      ref.setColumn(c, v);
+      ras.setColumn(c, v);
+    }
+    for (int i = 0; i < 2000; i++) {
+      Shape s = randomShape((Shape::Kind)(i % KINDS));
+      drawPoints(ref, s);
+      drawRaster(ras, s);
+      if (!sameBuffer(ref, ras)) {
+        if (mismatches++ < 5) {
+          printf("MISMATCH type %d %s r1=%d c1=%d r2=%d c2=%d w=%d\n", (int)type, KIND_NAMES[s.kind],
+                 s.r1, s.c1, s.r2, s.c2, s.width);
+        }
+        for (int16_t c = 0; c < COLS; c++) ras.setColumn(c, ref.getColumn(c));
+      }
+    }
+
+    // Snapshot: same columns as the buffer, and the same buffer once written
+    // back into a cleared chain
+    uint8_t digits[MAX_DEVICES * 8];
+    ras.getDigits(digits);
+    for (int16_t c = 0; c < COLS; c++) digitMismatches += ras.getDigitsColumn(digits, c) != ras.getColumn(c);
+    ref.clear();
+    ref.setDigits(digits);
+    digitMismatches += !sameBuffer(ref, ras);
+  }
+  printf("check: %d mismatches in %d shapes x %d module types, %d in digit snapshots\n", mismatches, 2000,
+         (int)(sizeof(TYPES) / sizeof(TYPES[0])), digitMismatches);
+
+  // Timing on the panel's wiring; the same shapes for both
+  MD_MAX72XX m(HARDWARE_TYPE, BENCH_DATA, BENCH_CLK, BENCH_CS, MAX_DEVICES);
+  startChain(m);
+  constexpr int SHAPES = 256;
+  printf("%-10s %12s %12s %8s   (ns per call, %u x %d shapes)\n", "primitive", "setPoint", "raster",
+         "speedup", iterations, SHAPES);
+  for (int k = 0; k < KINDS; k++) {
+    Shape shapes[SHAPES];
+    for (Shape &s : shapes) s = randomShape((Shape::Kind)k);
+
+    double ns[2];
+    for (int raster = 0; raster < 2; raster++) {
+      auto t0 = std::chrono::steady_clock::now();
+      for (unsigned it = 0; it < iterations; it++)
+        for (const Shape &s : shapes) raster ? drawRaster(m, s) : drawPoints(m, s);
+      ns[raster] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() /
+                   ((double)iterations * SHAPES);
+    }
+    printf("%-10s %12.1f %12.1f %7.1fx\n", KIND_NAMES[k], ns[0], ns[1], ns[0] / ns[1]);
+  }
+  return mismatches || digitMismatches ? 1 : 0;
+}
@@ -0,0 +1,63 @@
+// Coroutine runtime costs (hostMain --task-bench).
+//
+// Prints the frame size of every coroutine in main.cpp's TASK_FRAMES against
+// TASK_FRAME_SIZE, then times PatternScheduler::tick() with nothing due, a
+// due fiber resumed and re-suspended, and the same fiber parked inside a
+// nested child. Only the scheduler runs: no setup(), nothing is drawn.
+
+#include <Arduino.h>
+#include "hostRuntime.h"
+#include "patternTask.h"
+
+#include <chrono>
+
+// main.cpp
+const char *taskFrameName(uint8_t i);
+size_t taskFrameSize(uint8_t i);
+
+namespace {
+
+PatternTask sleepForever() {
+  for (;;) co_await sleepFor(1u << 30);
+}
+
+PatternTask yieldForever() {
+  for (;;) co_await sleepFor(0);
+}
+
+PatternTask nestedYield() {
+  co_await yieldForever();
+}
+
+// ns per tick() over `ticks` ticks with `task` as the only fiber
+double timeTicks(PatternTask task, unsigned ticks) {
+  patternScheduler.cancelAll();
+  patternScheduler.spawn(std::move(task));
+  uint32_t t = 1;
+  patternScheduler.tick(t);  // run up to the first co_await
+  auto t0 = std::chrono::steady_clock::now();
+  for (unsigned i = 0; i < ticks; i++) patternScheduler.tick(++t);
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+  patternScheduler.cancelAll();
+  return ns / ticks;
+}
+
+}  // namespace
+
+int runTaskBench(unsigned ticks) {
+  printf("%-14s %6s   (slots: %u x %u B)\n", "coroutine", "frame", (unsigned)TASK_FRAME_SLOTS,
+         (unsigned)TASK_FRAME_SIZE);
+  int oversized = 0;
+  for (uint8_t i = 0; taskFrameName(i); i++) {
+    size_t size = taskFrameSize(i);
+    oversized += size > TASK_FRAME_SIZE;
+    printf("%-14s %4u B%s\n", taskFrameName(i), (unsigned)size, size > TASK_FRAME_SIZE ? "  TOO BIG" : "");
+  }
+  printf("peakFrame      %4u B\n\n", (unsigned)taskArena.peakFrame);
+
+  printf("%-28s %8s   (%u ticks)\n", "tick()", "ns", ticks);
+  printf("%-28s %8.1f\n", "no fiber due", timeTicks(sleepForever(), ticks));
+  printf("%-28s %8.1f\n", "resume + re-suspend", timeTicks(yieldForever(), ticks));
+  printf("%-28s %8.1f\n", "same, inside a child", timeTicks(nestedYield(), ticks));
+  return oversized ? 1 : 0;
+}
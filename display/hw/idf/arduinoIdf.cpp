@@ -0,0 +1,230 @@
+#include <Arduino.h>
+#include <SPI.h>
+#include "idfRuntime.h"
+
+#include <algorithm>
+#include "driver/gpio.h"
+#include "driver/spi_master.h"
+#include "driver/usb_serial_jtag.h"
+#include "esp_attr.h"
+#include "esp_random.h"
+#include "esp_rom_sys.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+HardwareSerial Serial;
+SPIClass SPI;
+
+// --- CLOCK -----------------------------------------------------------------
+unsigned long millis() { return (unsigned long)(esp_timer_get_time() / 1000); }
+unsigned long micros() { return (unsigned long)esp_timer_get_time(); }
+
+void delay(unsigned long ms) { vTaskDelay(pdMS_TO_TICKS(ms)); }
+void delayMicroseconds(unsigned int us) { esp_rom_delay_us(us); }
+
+// Hardware RNG; nothing to seed
+void randomSeed(unsigned long) {}
+long random(long max) { return max > 0 ? (long)(esp_random() % (uint32_t)max) : 0; }
+long random(long min, long max) { return max > min ? min + random(max - min) : min; }
+
+// --- SERIAL ----------------------------------------------------------------
+// USB Serial/JTAG driver. Its RX ring buffer has no "bytes available" call,
+// so input is pulled into rxBuf and handed out from there. Neither does its
+// TX ring have a "space left" call, so output is queued in txBuf, whose free
+// space availableForWrite() reports, and moved on to the driver without
+// waiting (txPump) on every write and every loop (idfWaitInput).
+constexpr uint32_t USB_RX_BUFFER = 1024;   // > MAX_LINE, one ASSET DATA line
+constexpr uint32_t USB_TX_BUFFER = 1024;
+constexpr size_t USB_TX_CHUNK = 64;        // one USB packet
+constexpr TickType_t USB_TX_WAIT = pdMS_TO_TICKS(20);
+
+static uint8_t rxBuf[256];
+static size_t rxHead = 0, rxLen = 0;
+
+static void rxFill(TickType_t wait) {
+  if (rxHead < rxLen) return;
+  int n = usb_serial_jtag_read_bytes(rxBuf, sizeof rxBuf, wait);
+  rxHead = 0;
+  rxLen = n > 0 ? n : 0;
+}
+
+static uint8_t txBuf[USB_TX_BUFFER];
+static size_t txHead = 0, txLen = 0;
+
+// Moves queued output to the driver, waiting up to `wait` for the first
+// chunk only; true if anything moved
+static bool txPump(TickType_t wait) {
+  bool moved = false;
+  while (txLen) {
+    size_t n = std::min(std::min(txLen, USB_TX_CHUNK), sizeof txBuf - txHead);
+    int sent = usb_serial_jtag_write_bytes(txBuf + txHead, n, moved ? 0 : wait);
+    if (sent <= 0) break;
+    txHead = (txHead + sent) % sizeof txBuf;
+    txLen -= sent;
+    moved = true;
+  }
+  return moved;
+}
+
+void idfWaitInput(uint32_t ticks) {
+  txPump(0);
+  rxFill(ticks);
+}
+
+void HardwareSerial::begin(unsigned long) {
+  if (usb_serial_jtag_is_driver_installed()) return;
+  usb_serial_jtag_driver_config_t cfg = {};
+  cfg.rx_buffer_size = USB_RX_BUFFER;
+  cfg.tx_buffer_size = USB_TX_BUFFER;
+  usb_serial_jtag_driver_install(&cfg);
+}
+
+int HardwareSerial::available() {
+  rxFill(0);
+  return (int)(rxLen - rxHead);
+}
+
+int HardwareSerial::read() {
+  rxFill(0);
+  return rxHead < rxLen ? rxBuf[rxHead++] : -1;
+}
+
+// Nothing is queued while no host has the port open, so a missing reader
+// never stalls rendering. Otherwise only a write that doesn't fit txBuf
+// waits, up to USB_TX_WAIT per chunk; callers that check availableForWrite()
+// first (the mirror) never do.
+size_t HardwareSerial::write(const uint8_t *b, size_t n) {
+  if (!usb_serial_jtag_is_connected()) {
+    txHead = txLen = 0;
+    return n;
+  }
+  size_t done = 0;
+  while (done < n) {
+    if (txLen == sizeof txBuf && !txPump(USB_TX_WAIT)) break;
+    size_t tail = (txHead + txLen) % sizeof txBuf;
+    size_t m = std::min(n - done, std::min(sizeof txBuf - txLen, sizeof txBuf - tail));
+    memcpy(txBuf + tail, b + done, m);
+    txLen += m;
+    done += m;
+  }
+  txPump(0);
+  return done;
+}
+
+int HardwareSerial::availableForWrite() {
+  if (!usb_serial_jtag_is_connected()) return 0;
+  txPump(0);
+  return (int)(sizeof txBuf - txLen);
+}
+
+// --- PANEL -----------------------------------------------------------------
+// Every CS low..high window becomes one queued transaction, so a full frame
+// (one transaction per row) is handed to the DMA without waiting for the
+// previous row. Each slot owns its buffer; a slot is reused only after its
+// transaction has completed.
+constexpr uint8_t SPI_QUEUE = 8;
+constexpr size_t SPI_MAX_BYTES = 64;       // 2 bytes per module, 32 modules
+constexpr int SPI_CLOCK_HZ = 8 * 1000 * 1000;  // same as MD_MAX72XX hardware SPI
+
+struct SpiSlot {
+  spi_transaction_t t;
+  uint8_t data[SPI_MAX_BYTES];
+};
+
+static DMA_ATTR SpiSlot spiSlots[SPI_QUEUE];
+static spi_device_handle_t panelDev = nullptr;
+static uint8_t panelData = 0xFF, panelClk = 0xFF, panelCs = 0xFF;
+static uint8_t spiNext = 0, spiInFlight = 0;
+static SpiSlot *spiOpen = nullptr;         // CS is low, bytes go here
+
+void idfAttachPanel(uint8_t dataPin, uint8_t clkPin, uint8_t csPin) {
+  spi_bus_config_t bus = {};
+  bus.mosi_io_num = dataPin;
+  bus.miso_io_num = -1;
+  bus.sclk_io_num = clkPin;
+  bus.quadwp_io_num = -1;
+  bus.quadhd_io_num = -1;
+  bus.max_transfer_sz = SPI_MAX_BYTES;
+  ESP_ERROR_CHECK(spi_bus_initialize(SPI2_HOST, &bus, SPI_DMA_CH_AUTO));
+
+  spi_device_interface_config_t dev = {};
+  dev.clock_speed_hz = SPI_CLOCK_HZ;
+  dev.mode = 0;
+  dev.spics_io_num = csPin;
+  dev.queue_size = SPI_QUEUE;
+  ESP_ERROR_CHECK(spi_bus_add_device(SPI2_HOST, &dev, &panelDev));
+
+  panelData = dataPin;
+  panelClk = clkPin;
+  panelCs = csPin;
+}
+
+static void spiReclaim() {
+  spi_transaction_t *done;
+  spi_device_get_trans_result(panelDev, &done, portMAX_DELAY);
+  spiInFlight--;
+}
+
+static void spiSelect() {
+  if (spiInFlight == SPI_QUEUE) spiReclaim();
+  spiOpen = &spiSlots[spiNext];
+  spiOpen->t = {};
+  spiOpen->t.tx_buffer = spiOpen->data;
+}
+
+static void spiLatch() {
+  spi_transaction_t &t = spiOpen->t;
+  spiOpen = nullptr;
+  if (!t.length) return;
+  ESP_ERROR_CHECK(spi_device_queue_trans(panelDev, &t, portMAX_DELAY));
+  spiInFlight++;
+  spiNext = (spiNext + 1) % SPI_QUEUE;
+}
+
+static void spiByte(uint8_t b) {
+  if (!spiOpen) return;
+  size_t n = spiOpen->t.length / 8;
+  if (n < SPI_MAX_BYTES) {
+    spiOpen->data[n] = b;
+    spiOpen->t.length += 8;
+  }
+}
+
+// --- PINS ------------------------------------------------------------------
+static bool isPanelPin(uint8_t pin) {
+  return panelDev && (pin == panelData || pin == panelClk || pin == panelCs);
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  if (isPanelPin(pin)) return;             // owned by the SPI peripheral
+  gpio_reset_pin((gpio_num_t)pin);
+  gpio_set_direction((gpio_num_t)pin, mode == OUTPUT ? GPIO_MODE_OUTPUT : GPIO_MODE_INPUT);
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  if (isPanelPin(pin)) {
+    if (pin != panelCs) return;
+    if (val == LOW) spiSelect();
+    else if (spiOpen) spiLatch();
+    return;
+  }
+  gpio_set_level((gpio_num_t)pin, val);
+}
+
+int digitalRead(uint8_t pin) { return gpio_get_level((gpio_num_t)pin); }
+
+void shiftOut(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t val) {
+  if (dataPin != panelData || clockPin != panelClk) return;
+  if (bitOrder == LSBFIRST) {
+    uint8_t r = 0;
+    for (uint8_t i = 0; i < 8; i++) r |= ((val >> i) & 1) << (7 - i);
+    val = r;
+  }
+  spiByte(val);
+}
+
+uint8_t SPIClass::transfer(uint8_t b) {
+  spiByte(b);
+  return 0;
+}
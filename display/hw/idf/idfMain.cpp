@@ -0,0 +1,35 @@
+// ESP-IDF entry point for the Arduino-free build (pio run -e
+// seeed_xiao_esp32c6_idf): the same setup()/loop() and command protocol as
+// the Arduino build, on the Arduino API shim in host/ backed by the IDF
+// drivers (arduinoIdf.cpp).
+//
+// Differences from the Arduino build:
+//   - no USB CDC settle delay at boot (BOOT_DELAY_MS=0); the panel is
+//     cleared as soon as the SPI bus is up
+//   - panel rows go out as queued DMA SPI transactions, not bit-banged
+//   - loop() sleeps until serial input arrives or the next tick (1 ms), so
+//     the idle task and task watchdog run without slowing commands down
+//
+// Boot time to the first frame is logged as "#BOOT <ms> ms".
+
+#include <Arduino.h>
+#include "channels.h"
+#include "displayConfig.h"
+#include "idfRuntime.h"
+
+void setup();
+void loop();
+
+extern "C" void app_main() {
+  idfAttachPanel(DATA_PIN, CLK_PIN, CS_PIN);
+  setup();
+  if (beginLog()) {
+    Serial.print("BOOT ");
+    Serial.print(millis());
+    Serial.println(" ms");
+  }
+  for (;;) {
+    loop();
+    idfWaitInput(1);
+  }
+}
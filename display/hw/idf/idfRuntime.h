@@ -0,0 +1,21 @@
+#ifndef IDF_RUNTIME_H
+#define IDF_RUNTIME_H
+
+// Controls for the Arduino-free ESP-IDF build ([env:seeed_xiao_esp32c6_idf]),
+// used by idfMain.cpp. The firmware itself never includes this.
+
+#include <stdint.h>
+
+// --- PANEL -----------------------------------------------------------------
+// Puts the chain on the SPI peripheral: dataPin = MOSI, clkPin = SCLK and
+// csPin = hardware CS. From then on the bytes MD_MAX72XX bit-bangs with
+// shiftOut() between CS going low and high are sent as one DMA transaction.
+void idfAttachPanel(uint8_t dataPin, uint8_t clkPin, uint8_t csPin);
+
+// --- SERIAL ----------------------------------------------------------------
+// Hands queued output to the USB driver, then blocks for up to `ticks` until
+// serial input arrives; returns at once if some is already buffered. Lets the
+// idle task run between frames without adding latency to commands.
+void idfWaitInput(uint32_t ticks);
+
+#endif // IDF_RUNTIME_H
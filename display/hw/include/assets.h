@@ -0,0 +1,103 @@
+#ifndef ASSETS_H
+#define ASSETS_H
+
+// Asset bundle stored in its own flash partition (see partitions.csv).
+//
+// Two slots, assets_a and assets_b, each hold one bundle. The valid bundle
+// with the highest sequence number is memory-mapped at boot and read in
+// place: fonts, messages and sprites returned by the lookups below point
+// straight into flash, nothing is copied to RAM.
+//
+// Bundles are built by scripts/pack_display_assets.py and uploaded into the
+// inactive slot with ASSET BEGIN / DATA / COMMIT. COMMIT checks the CRC,
+// stamps the next sequence number into the header and swaps slots.
+//
+// Layout (little endian):
+//   AssetHeader                     32 bytes
+//   AssetEntry[count]               28 bytes each, sorted by name
+//   payloads                        4-byte aligned, referenced by offset
+
+#include <stddef.h>
+#include <stdint.h>
+#include "fonts.h"
+
+constexpr uint32_t ASSET_MAGIC        = 0x53414746;  // "FGAS"
+constexpr uint16_t ASSET_VERSION      = 1;
+constexpr uint8_t  ASSET_NAME_LEN     = 16;
+constexpr uint32_t ASSET_SLOT_SIZE    = 0x10000;     // must match partitions.csv
+constexpr uint32_t ASSET_SEQ_UNSET    = 0xFFFFFFFF;  // erased flash, stamped on commit
+constexpr uint8_t  ASSET_SUBTYPE      = 0x40;
+
+enum AssetType : uint8_t { ASSET_FONT = 1, ASSET_TEXT = 2, ASSET_SPRITE = 3 };
+
+struct AssetHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t count;        // index entries
+  uint32_t sequence;     // left erased by the packer, written by the device
+  uint32_t size;         // whole bundle including this header
+  uint32_t crc32;        // CRC-32 over bytes [sizeof(AssetHeader), size)
+  uint8_t reserved[12];
+};
+
+struct AssetEntry {
+  char name[ASSET_NAME_LEN];  // NUL padded, uppercase
+  uint8_t type;               // AssetType
+  uint8_t reserved[3];
+  uint32_t offset;            // from bundle start
+  uint32_t length;
+};
+
+// ASSET_FONT payload: same packing as PackedFont, ASCII 32..95
+struct AssetFont {
+  uint8_t width, height, yOffset, spaceWidth;
+  // uint8_t bits[(64 * width * height + 7) / 8 + 1];
+  // uint8_t spans[64];
+};
+
+// ASSET_SPRITE payload: frames of `width` column bytes (LSB = top row)
+struct AssetSprite {
+  uint16_t frameCount;
+  uint16_t frameMs;
+  uint8_t width;
+  uint8_t reserved[3];
+  // uint8_t columns[frameCount][width];
+};
+
+static_assert(sizeof(AssetHeader) == 32, "AssetHeader layout");
+static_assert(sizeof(AssetEntry) == 28, "AssetEntry layout");
+static_assert(sizeof(AssetSprite) == 8, "AssetSprite layout");
+
+struct AssetRef {
+  const uint8_t *data = nullptr;
+  uint32_t length = 0;
+  explicit operator bool() const { return data != nullptr; }
+};
+
+// --- MOUNTED BUNDLE --------------------------------------------------------
+bool assetsMount();                      // map the newest valid slot, call once from setup()
+bool assetsMounted();
+char assetsSlot();                       // 'A', 'B' or '-'
+const AssetHeader *assetsHeader();
+AssetRef assetFind(const char *name, AssetType type);  // binary search on the index
+
+// Message text, or `fallback` if the bundle has no such entry
+const char *assetText(const char *name, const char *fallback);
+
+// Font for FONTS[i]: the bundle's font of the same name if present
+const BitmapFont &assetFontOr(uint8_t i);
+
+// --- UPLOAD ----------------------------------------------------------------
+// Each returns nullptr on success or a short error for the ERR response.
+const char *assetUploadBegin(uint32_t size, uint32_t crc);
+const char *assetUploadData(uint32_t offset, const uint8_t *data, uint32_t len);
+// Commit verifies the upload first and calls beforeSwap (if given) only once
+// it succeeds, right before the old bundle is unmapped, so anything still
+// reading from it can stop there and a failed commit changes nothing.
+const char *assetUploadCommit(void (*beforeSwap)() = nullptr);
+void assetUploadAbort();
+
+// Same result as zlib's crc32(); pass 0 to start
+uint32_t crc32Update(uint32_t crc, const uint8_t *data, uint32_t len);
+
+#endif // ASSETS_H
@@ -0,0 +1,33 @@
+#ifndef CHANNELS_H
+#define CHANNELS_H
+
+// Serial output channels. The first byte of every line says which one it
+// belongs to, so the host can route lines without knowing every message:
+//
+//   OK... / ERR...  response, exactly one per command, sent last. Nothing
+//                   else starts with 'O' or 'E'.
+//   !<event>        unsolicited, for programs: "!PATTERN <name>",
+//                   "!SELFTEST <name> <done>/<total>|DONE", "!MF ..." (mirror.h)
+//   #<text>         log for people reading the port; `LOG OFF` stops it
+//
+// DisplayController.read_response() (src/display_controller.py) returns
+// only responses and routes the rest.
+
+#include <Arduino.h>
+
+constexpr char EVENT_PREFIX = '!';
+constexpr char LOG_PREFIX   = '#';
+
+inline bool logOn = true;    // LOG ON|OFF
+
+// Starts an event line; finish it with Serial.print()/println()
+inline void beginEvent() { Serial.print(EVENT_PREFIX); }
+
+// Starts a log line, or returns false and prints nothing while logging is off:
+//   if (beginLog()) Serial.println("...");
+inline bool beginLog() {
+  if (logOn) Serial.print(LOG_PREFIX);
+  return logOn;
+}
+
+#endif // CHANNELS_H
@@ -0,0 +1,12 @@
+#ifndef DISPLAY_CONFIG_H
+#define DISPLAY_CONFIG_H
+
+// Panel wiring, shared by the firmware and the host build (host/).
+
+#define HARDWARE_TYPE MD_MAX72XX::FC16_HW
+#define MAX_DEVICES 4
+#define CLK_PIN   0   // D0
+#define DATA_PIN  2   // D2 (DIN)
+#define CS_PIN    1   // D1
+
+#endif // DISPLAY_CONFIG_H
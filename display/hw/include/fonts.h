@@ -0,0 +1,291 @@
+#ifndef FONTS_H
+#define FONTS_H
+
+// Bitmap fonts for ASCII 32..95 (lowercase is folded to uppercase by the
+// command parser). Glyphs are authored below as column bytes (LSB = top row)
+// and bit-packed at compile time, so flash only holds width*height bits per
+// glyph plus one span byte used for proportional spacing.
+
+#include <stddef.h>
+#include <stdint.h>
+
+constexpr uint8_t FONT_FIRST_CHAR = 32;
+constexpr uint8_t FONT_GLYPHS     = 64;
+
+// --- GLYPH SOURCES ---------------------------------------------------------
+constexpr uint8_t GLYPHS_5x7[FONT_GLYPHS][5] = {
+  {0x00, 0x00, 0x00, 0x00, 0x00}, // space
+  {0x00, 0x00, 0x5F, 0x00, 0x00}, // !
+  {0x00, 0x07, 0x00, 0x07, 0x00}, // "
+  {0x14, 0x7F, 0x14, 0x7F, 0x14}, // #
+  {0x24, 0x2A, 0x7F, 0x2A, 0x12}, // $
+  {0x23, 0x13, 0x08, 0x64, 0x62}, // %
+  {0x36, 0x49, 0x55, 0x22, 0x50}, // &
+  {0x00, 0x05, 0x03, 0x00, 0x00}, // '
+  {0x00, 0x1C, 0x22, 0x41, 0x00}, // (
+  {0x00, 0x41, 0x22, 0x1C, 0x00}, // )
+  {0x14, 0x08, 0x3E, 0x08, 0x14}, // *
+  {0x08, 0x08, 0x3E, 0x08, 0x08}, // +
+  {0x00, 0x50, 0x30, 0x00, 0x00}, // ,
+  {0x08, 0x08, 0x08, 0x08, 0x08}, // -
+  {0x00, 0x60, 0x60, 0x00, 0x00}, // .
+  {0x20, 0x10, 0x08, 0x04, 0x02}, // /
+  {0x3E, 0x51, 0x49, 0x45, 0x3E}, // 0
+  {0x00, 0x42, 0x7F, 0x40, 0x00}, // 1
+  {0x42, 0x61, 0x51, 0x49, 0x46}, // 2
+  {0x21, 0x41, 0x45, 0x4B, 0x31}, // 3
+  {0x18, 0x14, 0x12, 0x7F, 0x10}, // 4
+  {0x27, 0x45, 0x45, 0x45, 0x39}, // 5
+  {0x3C, 0x4A, 0x49, 0x49, 0x30}, // 6
+  {0x01, 0x71, 0x09, 0x05, 0x03}, // 7
+  {0x36, 0x49, 0x49, 0x49, 0x36}, // 8
+  {0x06, 0x49, 0x49, 0x29, 0x1E}, // 9
+  {0x00, 0x36, 0x36, 0x00, 0x00}, // :
+  {0x00, 0x56, 0x36, 0x00, 0x00}, // ;
+  {0x08, 0x14, 0x22, 0x41, 0x00}, // <
+  {0x14, 0x14, 0x14, 0x14, 0x14}, // =
+  {0x00, 0x41, 0x22, 0x14, 0x08}, // >
+  {0x02, 0x01, 0x51, 0x09, 0x06}, // ?
+  {0x32, 0x49, 0x79, 0x41, 0x3E}, // @
+  {0x7E, 0x11, 0x11, 0x11, 0x7E}, // A
+  {0x7F, 0x49, 0x49, 0x49, 0x36}, // B
+  {0x3E, 0x41, 0x41, 0x41, 0x22}, // C
+  {0x7F, 0x41, 0x41, 0x22, 0x1C}, // D
+  {0x7F, 0x49, 0x49, 0x49, 0x41}, // E
+  {0x7F, 0x09, 0x09, 0x09, 0x01}, // F
+  {0x3E, 0x41, 0x49, 0x49, 0x7A}, // G
+  {0x7F, 0x08, 0x08, 0x08, 0x7F}, // H
+  {0x00, 0x41, 0x7F, 0x41, 0x00}, // I
+  {0x20, 0x40, 0x41, 0x3F, 0x01}, // J
+  {0x7F, 0x08, 0x14, 0x22, 0x41}, // K
+  {0x7F, 0x40, 0x40, 0x40, 0x40}, // L
+  {0x7F, 0x02, 0x0C, 0x02, 0x7F}, // M
+  {0x7F, 0x04, 0x08, 0x10, 0x7F}, // N
+  {0x3E, 0x41, 0x41, 0x41, 0x3E}, // O
+  {0x7F, 0x09, 0x09, 0x09, 0x06}, // P
+  {0x3E, 0x41, 0x51, 0x21, 0x5E}, // Q
+  {0x7F, 0x09, 0x19, 0x29, 0x46}, // R
+  {0x46, 0x49, 0x49, 0x49, 0x31}, // S
+  {0x01, 0x01, 0x7F, 0x01, 0x01}, // T
+  {0x3F, 0x40, 0x40, 0x40, 0x3F}, // U
+  {0x1F, 0x20, 0x40, 0x20, 0x1F}, // V
+  {0x3F, 0x40, 0x38, 0x40, 0x3F}, // W
+  {0x63, 0x14, 0x08, 0x14, 0x63}, // X
+  {0x07, 0x08, 0x70, 0x08, 0x07}, // Y
+  {0x61, 0x51, 0x49, 0x45, 0x43}, // Z
+  {0x00, 0x7F, 0x41, 0x41, 0x00}, // [
+  {0x02, 0x04, 0x08, 0x10, 0x20}, // \ (backslash)
+  {0x00, 0x41, 0x41, 0x7F, 0x00}, // ]
+  {0x04, 0x02, 0x01, 0x02, 0x04}, // ^
+  {0x40, 0x40, 0x40, 0x40, 0x40}, // _
+};
+
+// Condensed 4x7
+constexpr uint8_t GLYPHS_4x7[FONT_GLYPHS][4] = {
+  {0x00, 0x00, 0x00, 0x00}, // space
+  {0x00, 0x5F, 0x00, 0x00}, // !
+  {0x03, 0x00, 0x03, 0x00}, // "
+  {0x12, 0x3F, 0x12, 0x3F}, // #
+  {0x24, 0x2B, 0x7E, 0x12}, // $
+  {0x33, 0x0B, 0x64, 0x62}, // %
+  {0x36, 0x49, 0x56, 0x30}, // &
+  {0x00, 0x03, 0x00, 0x00}, // 
+  {0x1C, 0x22, 0x41, 0x00}, // (
+  {0x00, 0x41, 0x22, 0x1C}, // )
+  {0x2A, 0x1C, 0x1C, 0x2A}, // *
+  {0x08, 0x3E, 0x08, 0x00}, // +
+  {0x00, 0x50, 0x30, 0x00}, // ,
+  {0x08, 0x08, 0x08, 0x08}, // -
+  {0x00, 0x60, 0x60, 0x00}, // .
+  {0x30, 0x08, 0x04, 0x03}, // /
+  {0x3E, 0x49, 0x45, 0x3E}, // 0
+  {0x00, 0x42, 0x7F, 0x40}, // 1
+  {0x62, 0x51, 0x49, 0x46}, // 2
+  {0x41, 0x49, 0x49, 0x36}, // 3
+  {0x1C, 0x12, 0x7F, 0x10}, // 4
+  {0x27, 0x45, 0x45, 0x39}, // 5
+  {0x3E, 0x49, 0x49, 0x30}, // 6
+  {0x01, 0x71, 0x0D, 0x03}, // 7
+  {0x36, 0x49, 0x49, 0x36}, // 8
+  {0x06, 0x49, 0x49, 0x3E}, // 9
+  {0x00, 0x36, 0x36, 0x00}, // :
+  {0x00, 0x56, 0x36, 0x00}, // ;
+  {0x08, 0x14, 0x22, 0x41}, // <
+  {0x14, 0x14, 0x14, 0x14}, // =
+  {0x41, 0x22, 0x14, 0x08}, // >
+  {0x02, 0x51, 0x09, 0x06}, // ?
+  {0x3E, 0x41, 0x5D, 0x0E}, // @
+  {0x7E, 0x09, 0x09, 0x7E}, // A
+  {0x7F, 0x49, 0x49, 0x36}, // B
+  {0x3E, 0x41, 0x41, 0x22}, // C
+  {0x7F, 0x41, 0x41, 0x3E}, // D
+  {0x7F, 0x49, 0x49, 0x41}, // E
+  {0x7F, 0x09, 0x09, 0x01}, // F
+  {0x3E, 0x41, 0x49, 0x7A}, // G
+  {0x7F, 0x08, 0x08, 0x7F}, // H
+  {0x41, 0x7F, 0x41, 0x00}, // I
+  {0x20, 0x40, 0x41, 0x3F}, // J
+  {0x7F, 0x08, 0x14, 0x63}, // K
+  {0x7F, 0x40, 0x40, 0x40}, // L
+  {0x7F, 0x06, 0x06, 0x7F}, // M
+  {0x7F, 0x06, 0x18, 0x7F}, // N
+  {0x3E, 0x41, 0x41, 0x3E}, // O
+  {0x7F, 0x09, 0x09, 0x06}, // P
+  {0x3E, 0x41, 0x51, 0x7E}, // Q
+  {0x7F, 0x09, 0x19, 0x66}, // R
+  {0x46, 0x49, 0x49, 0x31}, // S
+  {0x01, 0x7F, 0x01, 0x00}, // T
+  {0x3F, 0x40, 0x40, 0x3F}, // U
+  {0x1F, 0x60, 0x60, 0x1F}, // V
+  {0x7F, 0x30, 0x30, 0x7F}, // W
+  {0x63, 0x1C, 0x1C, 0x63}, // X
+  {0x07, 0x78, 0x07, 0x00}, // Y
+  {0x71, 0x49, 0x45, 0x43}, // Z
+  {0x7F, 0x41, 0x41, 0x00}, // [
+  {0x03, 0x04, 0x08, 0x30}, // \ (backslash)
+  {0x00, 0x41, 0x41, 0x7F}, // ]
+  {0x02, 0x01, 0x02, 0x00}, // ^
+  {0x40, 0x40, 0x40, 0x40}, // _
+};
+
+// Tiny 3x5, drawn one row down so it sits in the middle of the matrix
+constexpr uint8_t GLYPHS_3x5[FONT_GLYPHS][3] = {
+  {0x00, 0x00, 0x00}, // space
+  {0x00, 0x17, 0x00}, // !
+  {0x03, 0x00, 0x03}, // "
+  {0x1F, 0x0A, 0x1F}, // #
+  {0x12, 0x1F, 0x09}, // $
+  {0x09, 0x04, 0x12}, // %
+  {0x0F, 0x17, 0x1C}, // &
+  {0x00, 0x03, 0x00}, // 
+  {0x00, 0x0E, 0x11}, // (
+  {0x11, 0x0E, 0x00}, // )
+  {0x05, 0x02, 0x05}, // *
+  {0x04, 0x0E, 0x04}, // +
+  {0x10, 0x08, 0x00}, // ,
+  {0x04, 0x04, 0x04}, // -
+  {0x00, 0x10, 0x00}, // .
+  {0x18, 0x04, 0x03}, // /
+  {0x1F, 0x11, 0x1F}, // 0
+  {0x12, 0x1F, 0x10}, // 1
+  {0x19, 0x15, 0x12}, // 2
+  {0x11, 0x15, 0x0A}, // 3
+  {0x07, 0x04, 0x1F}, // 4
+  {0x17, 0x15, 0x09}, // 5
+  {0x1E, 0x15, 0x1D}, // 6
+  {0x01, 0x1D, 0x03}, // 7
+  {0x1F, 0x15, 0x1F}, // 8
+  {0x17, 0x15, 0x0F}, // 9
+  {0x00, 0x0A, 0x00}, // :
+  {0x10, 0x0A, 0x00}, // ;
+  {0x04, 0x0A, 0x11}, // <
+  {0x0A, 0x0A, 0x0A}, // =
+  {0x11, 0x0A, 0x04}, // >
+  {0x01, 0x15, 0x02}, // ?
+  {0x0E, 0x15, 0x16}, // @
+  {0x1E, 0x05, 0x1E}, // A
+  {0x1F, 0x15, 0x0A}, // B
+  {0x0E, 0x11, 0x11}, // C
+  {0x1F, 0x11, 0x0E}, // D
+  {0x1F, 0x15, 0x15}, // E
+  {0x1F, 0x05, 0x05}, // F
+  {0x0E, 0x11, 0x1D}, // G
+  {0x1F, 0x04, 0x1F}, // H
+  {0x11, 0x1F, 0x11}, // I
+  {0x08, 0x10, 0x0F}, // J
+  {0x1F, 0x04, 0x1B}, // K
+  {0x1F, 0x10, 0x10}, // L
+  {0x1F, 0x06, 0x1F}, // M
+  {0x1F, 0x01, 0x1E}, // N
+  {0x0E, 0x11, 0x0E}, // O
+  {0x1F, 0x05, 0x02}, // P
+  {0x0E, 0x19, 0x1E}, // Q
+  {0x1F, 0x05, 0x1A}, // R
+  {0x12, 0x15, 0x09}, // S
+  {0x01, 0x1F, 0x01}, // T
+  {0x0F, 0x10, 0x1F}, // U
+  {0x07, 0x18, 0x07}, // V
+  {0x1F, 0x0C, 0x1F}, // W
+  {0x1B, 0x04, 0x1B}, // X
+  {0x03, 0x1C, 0x03}, // Y
+  {0x19, 0x15, 0x13}, // Z
+  {0x00, 0x1F, 0x11}, // [
+  {0x03, 0x04, 0x18}, // \ (backslash)
+  {0x11, 0x1F, 0x00}, // ]
+  {0x02, 0x01, 0x02}, // ^
+  {0x10, 0x10, 0x10}, // _
+};
+
+// --- PACKED STORAGE --------------------------------------------------------
+// bits:  glyph g, column c occupies H bits starting at bit (g*W + c)*H
+// spans: (first lit column << 4) | last lit column, 0xFF for blank glyphs
+template <uint8_t W, uint8_t H>
+struct PackedFont {
+  uint8_t bits[(FONT_GLYPHS * W * H + 7) / 8 + 1] = {};  // +1 so reads may run a byte past
+  uint8_t spans[FONT_GLYPHS] = {};
+
+  constexpr PackedFont(const uint8_t (&glyphs)[FONT_GLYPHS][W]) {
+    for (int g = 0; g < FONT_GLYPHS; g++) {
+      int first = -1, last = -1;
+      for (int c = 0; c < W; c++) {
+        uint8_t col = glyphs[g][c];
+        if (col) {
+          if (first < 0) first = c;
+          last = c;
+        }
+        for (int r = 0; r < H; r++) {
+          if (col & (1 << r)) {
+            int bit = (g * W + c) * H + r;
+            bits[bit >> 3] |= (uint8_t)(1 << (bit & 7));
+          }
+        }
+      }
+      spans[g] = first < 0 ? 0xFF : (uint8_t)((first << 4) | last);
+    }
+  }
+};
+
+inline constexpr PackedFont<5, 7> PACKED_5x7(GLYPHS_5x7);
+inline constexpr PackedFont<4, 7> PACKED_4x7(GLYPHS_4x7);
+inline constexpr PackedFont<3, 5> PACKED_3x5(GLYPHS_3x5);
+
+struct BitmapFont {
+  const char *name;
+  uint8_t width;       // glyph cell columns
+  uint8_t height;      // glyph rows
+  uint8_t yOffset;     // top row on the display
+  uint8_t spaceWidth;  // advance of a blank glyph in proportional mode
+  const uint8_t *bits;
+  const uint8_t *spans;
+};
+
+inline constexpr BitmapFont FONT_5x7 = { "5x7", 5, 7, 0, 3, PACKED_5x7.bits, PACKED_5x7.spans };
+inline constexpr BitmapFont FONT_4x7 = { "4x7", 4, 7, 0, 3, PACKED_4x7.bits, PACKED_4x7.spans };
+inline constexpr BitmapFont FONT_3x5 = { "3x5", 3, 5, 1, 2, PACKED_3x5.bits, PACKED_3x5.spans };
+
+// Largest first: fit-to-width takes the first one that fits
+inline constexpr const BitmapFont *FONTS[] = { &FONT_5x7, &FONT_4x7, &FONT_3x5 };
+constexpr uint8_t FONT_COUNT = sizeof(FONTS) / sizeof(FONTS[0]);
+
+// --- ACCESS ----------------------------------------------------------------
+inline uint8_t glyphIndex(char c) {
+  if (c < 32 || c > 95) return 0;
+  return c - FONT_FIRST_CHAR;
+}
+
+// Column bits of a glyph, LSB = top row
+inline uint8_t fontColumn(const BitmapFont &f, uint8_t glyph, uint8_t col) {
+  uint16_t bit = ((uint16_t)glyph * f.width + col) * f.height;
+  uint16_t window = f.bits[bit >> 3] | (f.bits[(bit >> 3) + 1] << 8);
+  return (window >> (bit & 7)) & ((1 << f.height) - 1);
+}
+
+// Horizontal advance of one glyph including the 1px gap after it
+inline uint8_t glyphAdvance(const BitmapFont &f, uint8_t glyph, bool proportional) {
+  if (!proportional) return f.width + 1;
+  uint8_t span = f.spans[glyph];
+  if (span == 0xFF) return f.spaceWidth;
+  return (span & 0x0F) - (span >> 4) + 2;
+}
+
+#endif // FONTS_H
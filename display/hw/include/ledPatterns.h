@@ -1,194 +1,181 @@
 #ifndef LED_PATTERNS_H
 #define LED_PATTERNS_H
 
+// Module self-tests, started with `SELFTEST <name> [FAST]`.
+//
+// Each test is a PatternTask run by patternScheduler, so serial commands are
+// still handled while a test is on screen and any new command aborts it.
+// Progress is reported as "!SELFTEST <name> <done>/<total>" events followed
+// by "!SELFTEST <name> DONE" (see channels.h). FAST divides every step by SELFTEST_FAST_DIVIDER.
+
 #include <MD_MAX72xx.h>
+#include "channels.h"
+#include "overlay.h"
+#include "patternTask.h"
 
 extern MD_MAX72XX mx;
-extern const int MAX_DEVICES;
 
-void testAllSingleLEDs() {
-  Serial.println("\n>>> TEST 1: Single LED Scan (All 256 LEDs)");
-  Serial.println("Each LED will light individually for 50ms");
-  
-  int ledCount = 0;
+constexpr uint8_t SELFTEST_FAST_DIVIDER = 10;
+inline uint8_t selfTestDivider = 1;
+
+inline SleepAwaiter testDelay(uint32_t ms) { return sleepFor(ms / selfTestDivider); }
+
+inline void reportProgress(const char *name, int done, int total) {
+  beginEvent();
+  Serial.print("SELFTEST ");
+  Serial.print(name);
+  Serial.print(' ');
+  Serial.print(done);
+  Serial.print('/');
+  Serial.println(total);
+}
+
+inline void reportDone(const char *name) {
+  beginEvent();
+  Serial.print("SELFTEST ");
+  Serial.print(name);
+  Serial.println(" DONE");
+}
+
+// Single LED scan, every LED on its own for 50ms
+inline PatternTask testAllSingleLEDs() {
   for (int row = 0; row < 8; row++) {
-    for (int col = 0; col < MAX_DEVICES * 8; col++) {
+    for (int col = 0; col < mx.getColumnCount(); col++) {
       mx.clear();
       mx.setPoint(row, col, true);
-      mx.update();
-      
-      ledCount++;
-      if (col % 8 == 0 && col > 0) {
-        Serial.print("  Module ");
-        Serial.print(col / 8);
-        Serial.println();
-      }
-      
-      delay(50);
+      flushFrame();
+      co_await testDelay(50);
     }
-    Serial.print("Row ");
-    Serial.print(row);
-    Serial.print(" complete (");
-    Serial.print(ledCount);
-    Serial.println(" LEDs tested)");
+    reportProgress("LEDS", row + 1, 8);
   }
-  
   mx.clear();
-  mx.update();
-  Serial.println("Single LED test complete!\n");
-  delay(2000);
+  flushFrame();
+  co_await testDelay(2000);
 }
 
-void testAllLEDsOn() {
-  Serial.println("\n>>> TEST 2: All LEDs ON");
-  
+inline PatternTask testAllLEDsOn() {
   for (int r = 0; r < 8; r++) {
-    for (int c = 0; c < MAX_DEVICES * 8; c++) {
+    for (int c = 0; c < mx.getColumnCount(); c++) {
       mx.setPoint(r, c, true);
     }
   }
-  mx.update();
-  
-  Serial.print("All ");
-  Serial.print(8 * MAX_DEVICES * 8);
-  Serial.println(" LEDs should be ON");
-  delay(3000);
-  
+  flushFrame();
+  reportProgress("ALLON", 1, 1);
+  co_await testDelay(3000);
+
   mx.clear();
-  mx.update();
-  delay(500);
+  flushFrame();
+  co_await testDelay(500);
 }
 
-void testRows() {
-  Serial.println("\n>>> TEST 3: Row-by-Row Test");
-  
+inline PatternTask testRows() {
   for (int row = 0; row < 8; row++) {
     mx.clear();
-    
-    for (int col = 0; col < MAX_DEVICES * 8; col++) {
+    for (int col = 0; col < mx.getColumnCount(); col++) {
       mx.setPoint(row, col, true);
     }
-    mx.update();
-    
-    Serial.print("Row ");
-    Serial.print(row);
-    Serial.println(" ON");
-    delay(500);
+    flushFrame();
+    reportProgress("ROWS", row + 1, 8);
+    co_await testDelay(500);
   }
-  
   mx.clear();
-  mx.update();
-  Serial.println("Row test complete\n");
-  delay(500);
+  flushFrame();
+  co_await testDelay(500);
 }
 
-void testColumns() {
-  Serial.println("\n>>> TEST 4: Column-by-Column Test");
-  
-  for (int col = 0; col < MAX_DEVICES * 8; col++) {
+inline PatternTask testColumns() {
+  int cols = mx.getColumnCount();
+  for (int col = 0; col < cols; col++) {
     mx.clear();
-    
     for (int row = 0; row < 8; row++) {
       mx.setPoint(row, col, true);
     }
-    mx.update();
-    
-    if (col % 8 == 0) {
-      Serial.print("Module ");
-      Serial.print(col / 8);
-      Serial.print(": ");
-    }
-    Serial.print(col % 8);
-    Serial.print(" ");
-    
-    if (col % 8 == 7) {
-      Serial.println();
-    }
-    
-    delay(50);
+    flushFrame();
+    if (col % 8 == 7) reportProgress("COLUMNS", col + 1, cols);
+    co_await testDelay(50);
   }
-  
   mx.clear();
-  mx.update();
-  Serial.println("Column test complete\n");
-  delay(500);
+  flushFrame();
+  co_await testDelay(500);
 }
 
-void testModules() {
-  Serial.println("\n>>> TEST 5: Module-by-Module Test");
-  
-  for (int module = 0; module < MAX_DEVICES; module++) {
+inline PatternTask testModules() {
+  int modules = mx.getDeviceCount();
+  for (int module = 0; module < modules; module++) {
     mx.clear();
-    
     int startCol = module * 8;
     int endCol = startCol + 8;
-    
     for (int row = 0; row < 8; row++) {
       for (int col = startCol; col < endCol; col++) {
         mx.setPoint(row, col, true);
       }
     }
-    mx.update();
-    
-    Serial.print("Module ");
-    Serial.print(module);
-    Serial.println(" ON (columns ");
-    Serial.print(startCol);
-    Serial.print("-");
-    Serial.print(endCol - 1);
-    Serial.println(")");
-    
-    delay(1000);
+    flushFrame();
+    reportProgress("MODULES", module + 1, modules);
+    co_await testDelay(1000);
   }
-  
   mx.clear();
-  mx.update();
-  Serial.println("Module test complete\n");
-  delay(500);
+  flushFrame();
+  co_await testDelay(500);
 }
 
-void testCheckerboard() {
-  Serial.println("\n>>> TEST 6: Checkerboard Pattern");
-  
+inline PatternTask testCheckerboard() {
   mx.clear();
-  int onCount = 0;
-  
   for (int row = 0; row < 8; row++) {
-    for (int col = 0; col < MAX_DEVICES * 8; col++) {
-      if ((row + col) % 2 == 0) {
-        mx.setPoint(row, col, true);
-        onCount++;
-      }
+    for (int col = 0; col < mx.getColumnCount(); col++) {
+      if ((row + col) % 2 == 0) mx.setPoint(row, col, true);
     }
   }
-  mx.update();
-  
-  Serial.print("Checkerboard: ");
-  Serial.print(onCount);
-  Serial.println(" LEDs ON");
-  delay(2000);
-  
+  flushFrame();
+  reportProgress("CHECKER", 1, 1);
+  co_await testDelay(2000);
+
   mx.clear();
-  mx.update();
-  delay(500);
+  flushFrame();
+  co_await testDelay(500);
 }
 
-void testCorners() {
-  Serial.println("\n>>> TEST 7: Four Corners");
-  
+inline PatternTask testCorners() {
+  int last = mx.getColumnCount() - 1;
   mx.clear();
-  mx.setPoint(0, 0, true);                          // Top-Left
-  mx.setPoint(0, MAX_DEVICES * 8 - 1, true);        // Top-Right
-  mx.setPoint(7, 0, true);                          // Bottom-Left
-  mx.setPoint(7, MAX_DEVICES * 8 - 1, true);        // Bottom-Right
-  mx.update();
-  
-  Serial.println("All 4 corners should be lit");
-  delay(2000);
-  
+  mx.setPoint(0, 0, true);       // Top-Left
+  mx.setPoint(0, last, true);    // Top-Right
+  mx.setPoint(7, 0, true);       // Bottom-Left
+  mx.setPoint(7, last, true);    // Bottom-Right
+  flushFrame();
+  reportProgress("CORNERS", 1, 1);
+  co_await testDelay(2000);
+
   mx.clear();
-  mx.update();
-  delay(500);
+  flushFrame();
+  co_await testDelay(500);
+}
+
+struct SelfTest {
+  const char *name;
+  PatternTask (*run)();
+};
+
+inline constexpr SelfTest SELF_TESTS[] = {
+  { "LEDS",    testAllSingleLEDs },
+  { "ALLON",   testAllLEDsOn },
+  { "ROWS",    testRows },
+  { "COLUMNS", testColumns },
+  { "MODULES", testModules },
+  { "CHECKER", testCheckerboard },
+  { "CORNERS", testCorners },
+};
+constexpr uint8_t SELF_TEST_COUNT = sizeof(SELF_TESTS) / sizeof(SELF_TESTS[0]);
+
+// Runs one test, or all of them in order when index == SELF_TEST_COUNT
+inline PatternTask runSelfTests(uint8_t index) {
+  uint8_t first = index < SELF_TEST_COUNT ? index : 0;
+  uint8_t last = index < SELF_TEST_COUNT ? index : SELF_TEST_COUNT - 1;
+  for (uint8_t i = first; i <= last; i++) {
+    co_await SELF_TESTS[i].run();
+    reportDone(SELF_TESTS[i].name);
+  }
+  if (index >= SELF_TEST_COUNT) reportDone("ALL");
 }
 
 #endif // LED_PATTERNS_H
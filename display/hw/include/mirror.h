@@ -0,0 +1,42 @@
+#ifndef MIRROR_H
+#define MIRROR_H
+
+// Framebuffer mirroring back to the host, enabled with `MIRROR ON [hz]`.
+//
+// At most `hz` times per second the framebuffer is compared with the last
+// frame the host received and only the difference is sent, as one line:
+//
+//   !MF <seq> <op> <hex>          (an event line, see channels.h)
+//
+//   seq  0..255, +1 per frame sent. A gap means a frame was lost and the
+//        host should wait for the next keyframe.
+//   op   K       keyframe, delta against a blank frame
+//        -3..3   delta against the previous frame shifted left by op
+//                columns (negative = right), vacated columns blank.
+//                Scrolling text then costs one or two columns per frame.
+//   hex  tokens, each a byte:
+//          0x00..0x7F  skip n+1 unchanged columns
+//          0x80..0xFF  n-0x7F XOR bytes follow
+//        Trailing unchanged columns are omitted.
+//
+// Columns are sent left to right, LSB = top row (same as sprites). Unchanged
+// frames send nothing; a keyframe goes out every MIRROR_KEYFRAME_MS so a host
+// that attaches late or drops a line resynchronises. Frames are skipped,
+// never queued, when the serial TX buffer cannot take the whole line, so a
+// slow or absent reader never stalls rendering. src/display_mirror.py decodes.
+
+#include <stdint.h>
+
+constexpr uint8_t  MIRROR_DEFAULT_HZ  = 10;
+constexpr uint8_t  MIRROR_MAX_HZ      = 25;
+constexpr uint32_t MIRROR_KEYFRAME_MS = 2000;
+constexpr int8_t   MIRROR_MAX_SHIFT   = 3;
+constexpr uint8_t  MIRROR_MAX_COLUMNS = 64;
+
+void mirrorStart(uint8_t hz);   // also forces a keyframe
+void mirrorStop();
+bool mirrorEnabled();
+uint8_t mirrorHz();
+void mirrorTick(unsigned long now);  // call from loop() after rendering
+
+#endif // MIRROR_H
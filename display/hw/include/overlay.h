@@ -0,0 +1,53 @@
+#ifndef OVERLAY_H
+#define OVERLAY_H
+
+// Overlays shown on top of the running pattern, e.g. a short notice, without
+// stopping it: when an overlay times out the pattern is simply visible again,
+// having kept running underneath.
+//
+// Layer 0 is the base: whatever the pattern draws into mx's buffer. Layers
+// 1..OVERLAY_LAYERS sit above it in order. Every frame goes out through
+// flushFrame() instead of mx.update(); with overlays active it blits the
+// pixels they change into mx's buffer, sends that, and blits the base pixels
+// back, so patterns never see the overlays in mx's buffer and only rows an
+// overlay or the pattern changed go out.
+//
+// Frames are handled as FRAME_WORDS 32-bit words of mx's raw digit registers
+// (mx.getDigits()): digit d of all four modules in one word, which on FC16
+// modules is one panel row. Compositing never transposes to columns, and each
+// blend is a couple of word operations per row, whatever the layers contain:
+//   BLEND_BOX    (base & ~mask) | bits   bits on a cleared box
+//   BLEND_OR     base | bits
+//   BLEND_XOR    base ^ bits
+//   BLEND_ERASE  base & ~bits
+
+#include <stdint.h>
+#include "displayConfig.h"
+
+constexpr uint8_t OVERLAY_LAYERS = 3;
+constexpr uint8_t FRAME_COLUMNS  = MAX_DEVICES * 8;
+constexpr uint8_t FRAME_WORDS    = FRAME_COLUMNS / 4;
+
+enum Blend : uint8_t { BLEND_BOX, BLEND_OR, BLEND_XOR, BLEND_ERASE };
+
+// Sends mx's buffer with the active overlays on top
+void flushFrame();
+
+// Column c as it is on the panel, overlays included (same bit order as
+// mx.getColumn())
+uint8_t frameColumn(uint8_t c);
+
+// Takes whatever has been drawn into mx's buffer since overlayBegin() as the
+// image of layer z (1..OVERLAY_LAYERS) and restores the base underneath:
+//   overlayBegin();  mx.clear();  drawText(...);  overlayEnd(z, BLEND_BOX, 2000);
+// The mask covers the drawn columns plus one column each side. ms = 0 shows
+// it until overlayHide().
+void overlayBegin();
+void overlayEnd(uint8_t z, Blend blend, unsigned long ms);
+void overlayHide(uint8_t z);      // 0 hides all
+bool overlayActive(uint8_t z);
+uint8_t overlayCount();            // active layers
+
+void overlayTick(unsigned long now);  // call from loop(); expires overlays
+
+#endif // OVERLAY_H
@@ -0,0 +1,246 @@
+#ifndef PATTERN_TASK_H
+#define PATTERN_TASK_H
+
+// Coroutine runtime for display patterns.
+//
+// A pattern is written as straight-line code returning PatternTask:
+//
+//   PatternTask blinkTwice() {
+//     for (int i = 0; i < 2; i++) {
+//       drawCentered("HI");
+//       co_await sleepFor(200);
+//       clearAll();
+//       co_await sleepFor(200);
+//     }
+//   }
+//
+// Coroutine frames never touch the heap: PatternTask::promise_type routes
+// operator new to a fixed arena of TASK_FRAME_SLOTS x TASK_FRAME_SIZE bytes.
+// A task can co_await another PatternTask (e.g. scrollOnce(text)); the child
+// runs to completion and then hands control straight back to its parent.
+// A child that gets no frame (arena full, or a frame over TASK_FRAME_SIZE)
+// parks the parent until the next tick(), so a retrying loop can't spin;
+// taskArena.failures counts these for the firmware to log.
+//
+// The scheduler keeps one fiber per spawned root task and only resumes a fiber
+// once its deadline has passed, so idle patterns cost a compare per loop().
+//
+// `program --task-bench` on the host build (g++ 12, -O2, x86-64), 3 runs:
+//   - frame sizes: 56-96 B (scrollOnce 64, scrollForever 72, blinkError 56,
+//     farewell 96, playSprite 88); frames hold pointers, so they differ on
+//     the 32-bit C6, where setup() checks them (TASK_FRAMES in main.cpp)
+//   - tick() with no fiber due: 2.6-2.8 ns
+//   - resume + re-suspend of a due fiber: 2.2-3.6 ns, 1.7-2.7 ns when it is
+//     parked inside a nested child; run-to-run noise exceeds the difference
+
+#include <coroutine>
+#include <chrono>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+constexpr size_t  TASK_FRAME_SIZE  = 160;  // bytes per coroutine frame slot
+constexpr uint8_t TASK_FRAME_SLOTS = 4;    // frames alive at once (roots + children)
+constexpr uint8_t TASK_FIBERS      = 2;    // root tasks running at once
+
+// --- FRAME ARENA -----------------------------------------------------------
+class TaskArena {
+public:
+  void* allocate(size_t size) {
+    lastFrame = size;
+    if (size > TASK_FRAME_SIZE) return fail(size);
+    for (uint8_t i = 0; i < TASK_FRAME_SLOTS; i++) {
+      if (!(used & (1u << i))) {
+        used |= (1u << i);
+        if (size > peakFrame) peakFrame = size;
+        return slots[i].bytes;
+      }
+    }
+    return fail(size);
+  }
+
+  void release(void* p) {
+    for (uint8_t i = 0; i < TASK_FRAME_SLOTS; i++) {
+      if (p == slots[i].bytes) {
+        used &= ~(1u << i);
+        return;
+      }
+    }
+  }
+
+  uint8_t inUse() const { return __builtin_popcount(used); }
+  size_t peakFrame = 0;    // largest frame requested so far
+  size_t lastFrame = 0;    // size of the latest request
+  uint32_t failures = 0;   // requests that got no frame
+  size_t failedFrame = 0;  // size of the latest of those
+
+private:
+  void* fail(size_t size) {
+    failures++;
+    failedFrame = size;
+    return nullptr;
+  }
+
+  struct alignas(max_align_t) Slot { uint8_t bytes[TASK_FRAME_SIZE]; };
+  Slot slots[TASK_FRAME_SLOTS];
+  uint32_t used = 0;
+};
+
+inline TaskArena taskArena;
+
+// --- TASK TYPE -------------------------------------------------------------
+class PatternTask {
+public:
+  struct promise_type {
+    std::coroutine_handle<> continuation;  // parent awaiting this task, if any
+
+    static void* operator new(size_t size) noexcept { return taskArena.allocate(size); }
+    static void operator delete(void* p) noexcept { taskArena.release(p); }
+    static PatternTask get_return_object_on_allocation_failure() { return PatternTask(); }
+
+    PatternTask get_return_object() {
+      return PatternTask(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    struct FinalAwaiter {
+      bool await_ready() noexcept { return false; }
+      std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+        std::coroutine_handle<> next = h.promise().continuation;
+        return next ? next : std::noop_coroutine();
+      }
+      void await_resume() noexcept {}
+    };
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    void return_void() {}
+    void unhandled_exception() { abort(); }
+  };
+
+  using Handle = std::coroutine_handle<promise_type>;
+
+  PatternTask() = default;
+  explicit PatternTask(Handle h) : handle(h) {}
+  PatternTask(PatternTask &&o) noexcept : handle(o.handle) { o.handle = nullptr; }
+  PatternTask &operator=(PatternTask &&o) noexcept {
+    if (this != &o) {
+      if (handle) handle.destroy();
+      handle = o.handle;
+      o.handle = nullptr;
+    }
+    return *this;
+  }
+  PatternTask(const PatternTask &) = delete;
+  PatternTask &operator=(const PatternTask &) = delete;
+  ~PatternTask() { if (handle) handle.destroy(); }
+
+  bool valid() const { return (bool)handle; }
+  Handle release() { Handle h = handle; handle = nullptr; return h; }
+
+  // co_await child: start it and come back here once it has finished.
+  // A child that could not get a frame is skipped, after waiting one tick.
+  bool await_ready() const noexcept { return handle && handle.done(); }
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<> parent) noexcept;
+  void await_resume() const noexcept {}
+
+private:
+  Handle handle;
+};
+
+// --- SCHEDULER -------------------------------------------------------------
+class PatternScheduler {
+public:
+  struct Fiber {
+    PatternTask::Handle root;
+    std::coroutine_handle<> resumeAt;  // innermost suspended coroutine
+    uint32_t wakeAt = 0;
+  };
+
+  // Takes ownership of a root task; it first runs on the next tick().
+  bool spawn(PatternTask &&task) {
+    if (!task.valid()) return false;
+    for (uint8_t i = 0; i < TASK_FIBERS; i++) {
+      if (!fibers[i].root) {
+        fibers[i].root = task.release();
+        fibers[i].resumeAt = fibers[i].root;
+        fibers[i].wakeAt = now;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void tick(uint32_t t) {
+    now = t;
+    for (uint8_t i = 0; i < TASK_FIBERS; i++) {
+      Fiber &f = fibers[i];
+      if (!f.root || (int32_t)(now - f.wakeAt) < 0) continue;
+      current = &f;
+      f.resumeAt.resume();
+      current = nullptr;
+      if (f.root.done()) kill(f);
+    }
+  }
+
+  // Destroying a root also destroys any child frames it is awaiting.
+  void cancelAll() {
+    for (uint8_t i = 0; i < TASK_FIBERS; i++) {
+      if (fibers[i].root) kill(fibers[i]);
+    }
+  }
+
+  bool idle() const {
+    for (uint8_t i = 0; i < TASK_FIBERS; i++) {
+      if (fibers[i].root) return false;
+    }
+    return true;
+  }
+
+  uint32_t now = 0;
+  Fiber *current = nullptr;
+
+private:
+  void kill(Fiber &f) {
+    f.root.destroy();
+    f.root = nullptr;
+    f.resumeAt = nullptr;
+  }
+
+  Fiber fibers[TASK_FIBERS];
+};
+
+inline PatternScheduler patternScheduler;
+
+inline std::coroutine_handle<> PatternTask::await_suspend(std::coroutine_handle<> parent) noexcept {
+  if (handle) {
+    handle.promise().continuation = parent;
+    return handle;
+  }
+  // No frame: park the parent like sleepFor(0)
+  PatternScheduler::Fiber *f = patternScheduler.current;
+  if (!f) return parent;
+  f->wakeAt = patternScheduler.now;
+  f->resumeAt = parent;
+  return std::noop_coroutine();
+}
+
+// --- AWAITABLES ------------------------------------------------------------
+struct SleepAwaiter {
+  uint32_t ms;
+  bool await_ready() const noexcept { return patternScheduler.current == nullptr; }
+  void await_suspend(std::coroutine_handle<> h) noexcept {
+    patternScheduler.current->wakeAt = patternScheduler.now + ms;
+    patternScheduler.current->resumeAt = h;
+  }
+  void await_resume() const noexcept {}
+};
+
+// Suspend the calling pattern; 0 means "next loop()"
+inline SleepAwaiter sleepFor(uint32_t ms) { return SleepAwaiter{ ms }; }
+
+template <class Rep, class Period>
+inline SleepAwaiter sleepFor(std::chrono::duration<Rep, Period> d) {
+  return SleepAwaiter{ (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(d).count() };
+}
+
+#endif // PATTERN_TASK_H
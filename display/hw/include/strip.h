@@ -0,0 +1,30 @@
+#ifndef STRIP_H
+#define STRIP_H
+
+// Bitmap strip rendered on the host, for text the built-in fonts can't show
+// (umlauts, lowercase, any TrueType font) and icons.
+//
+//   STRIP BEGIN <width> <crc32 hex>   start an upload of `width` columns
+//   STRIP DATA <offset> <hex bytes>   next chunk, offsets must be sequential;
+//                                     the last one checks the CRC
+//   STRIP SHOW [CENTER|LEFT|RIGHT|LOOP]
+//
+// Columns are bytes with LSB = top row, like sprites. The strip lives in a
+// fixed RAM pool and is shown by the TEXT scroll engine; each frame copies
+// only the visible window, so frame cost doesn't depend on the strip width.
+// src/display_strip.py renders strips and DisplayController.show_strip()
+// uploads them.
+
+#include <stdint.h>
+
+constexpr uint16_t STRIP_MAX_COLUMNS = 2048;   // pool size in bytes
+
+// Each returns nullptr on success or a short error for the ERR response.
+const char *stripBegin(uint32_t width, uint32_t crc);
+const char *stripData(uint32_t offset, const uint8_t *data, uint32_t len);
+
+bool stripReady();                 // complete upload with a matching CRC
+uint16_t stripWidth();
+const uint8_t *stripColumns();
+
+#endif // STRIP_H
@@ -826,6 +826,144 @@ public:
   void wraparound(controlValue_t mode) { control(WRAPAROUND, mode); };
   /** @} */
 
+  //--------------------------------------------------------------
+  /** \name Methods for raster drawing.
+   * @{
+   */
+
+  /**
+   * Set or clear a filled rectangle of LEDs.
+   *
+   * The rectangle includes both corners, which may be given in any order
+   * and may lie partly or wholly outside the pixel field; it is clipped
+   * once and then drawn a whole digit byte at a time per device, so the
+   * cost depends on the number of rows and devices covered rather than
+   * on the number of pixels. Only digits whose value changes are marked
+   * for the next update.
+   *
+   * \param r1    row of the first corner.
+   * \param c1    column of the first corner.
+   * \param r2    row of the opposite corner.
+   * \param c2    column of the opposite corner.
+   * \param state true - switch on; false - switch off.
+   * \return false if the rectangle is entirely outside the field, true otherwise.
+   */
+  bool fillRect(int16_t r1, int16_t c1, int16_t r2, int16_t c2, bool state);
+
+  /**
+   * Set or clear a horizontal run of LEDs in one row.
+   *
+   * Columns c1 to c2 inclusive, clipped to the field. See fillRect().
+   *
+   * \param r     row of the span.
+   * \param c1    first column.
+   * \param c2    last column.
+   * \param state true - switch on; false - switch off.
+   * \return false if the span is entirely outside the field, true otherwise.
+   */
+  bool setHSpan(int16_t r, int16_t c1, int16_t c2, bool state) { return fillRect(r, c1, r, c2, state); };
+
+  /**
+   * Set or clear a vertical run of LEDs in one column.
+   *
+   * Rows r1 to r2 inclusive, clipped to the field. See fillRect().
+   *
+   * \param c     column of the span.
+   * \param r1    first row.
+   * \param r2    last row.
+   * \param state true - switch on; false - switch off.
+   * \return false if the span is entirely outside the field, true otherwise.
+   */
+  bool setVSpan(int16_t c, int16_t r1, int16_t r2, bool state) { return fillRect(r1, c, r2, c, state); };
+
+  /**
+   * Set or clear the outline of a rectangle.
+   *
+   * Same coordinates and clipping as fillRect(); the four edges are drawn
+   * as spans.
+   *
+   * \param r1    row of the first corner.
+   * \param c1    column of the first corner.
+   * \param r2    row of the opposite corner.
+   * \param c2    column of the opposite corner.
+   * \param state true - switch on; false - switch off.
+   * \return false if the outline is entirely outside the field, true otherwise.
+   */
+  bool drawRect(int16_t r1, int16_t c1, int16_t r2, int16_t c2, bool state);
+
+  /**
+   * Set or clear a straight line of LEDs.
+   *
+   * The line from (r1, c1) to (r2, c2), both ends included, is traced with
+   * Bresenham's algorithm. Each straight run of pixels along a row or
+   * column is drawn as one span, and pixels outside the field are clipped.
+   *
+   * \param r1    row of the start point.
+   * \param c1    column of the start point.
+   * \param r2    row of the end point.
+   * \param c2    column of the end point.
+   * \param state true - switch on; false - switch off.
+   * \return false if the line is entirely outside the field, true otherwise.
+   */
+  bool drawLine(int16_t r1, int16_t c1, int16_t r2, int16_t c2, bool state);
+
+  /**
+   * Copy a bitmap into the pixel field, optionally through a mask.
+   *
+   * The bitmap is a sequence of column bytes in the same format as
+   * setColumn() (least significant bit is the lowest row number), placed
+   * with data[0] at column c and the following bytes at increasing column
+   * numbers. c may be negative and the bitmap may run past the last column;
+   * only the visible part is copied. Where a mask bit is 1 the LED takes
+   * the bitmap value, where it is 0 the LED is left unchanged. Pass the
+   * bitmap itself as the mask to only switch LEDs on (transparent blit),
+   * or NULL to replace whole columns.
+   *
+   * \param c     column for the first bitmap column.
+   * \param data  pointer to the bitmap column bytes.
+   * \param width number of columns in the bitmap.
+   * \param mask  pointer to width mask bytes, or NULL for all rows.
+   * \return false if parameter errors or nothing is visible, true otherwise.
+   */
+  bool blit(int16_t c, const uint8_t *data, uint16_t width, const uint8_t *mask = NULL);
+
+  /**
+   * Copy the digit registers of every device, as they are sent.
+   *
+   * Byte d * getDeviceCount() + dev of digits is digit d of device dev, so
+   * for up to 4 devices each digit of the whole chain is one 32-bit word;
+   * on modules whose digits are rows (FC16_HW, PAROLA_HW) that word is one
+   * panel row. Which pixel each bit is depends on the module type, so the
+   * snapshot suits bitwise compositing of snapshots taken the same way, and
+   * getDigitsColumn() reads pixels back out of it.
+   *
+   * \param digits  getDeviceCount() * 8 bytes for the snapshot.
+   */
+  void getDigits(uint8_t *digits);
+
+  /**
+   * Write digit registers from a getDigits() snapshot, optionally through
+   * a mask.
+   *
+   * Where a mask bit is 1 the digit bit takes the snapshot value, where it
+   * is 0 it is left unchanged; NULL writes every bit. Only digits whose
+   * value changes are marked for the next update.
+   *
+   * \param digits  snapshot in getDigits() layout.
+   * \param mask    mask bytes in the same layout, or NULL.
+   */
+  void setDigits(const uint8_t *digits, const uint8_t *mask = NULL);
+
+  /**
+   * Get one column of a getDigits() snapshot.
+   *
+   * \param digits  snapshot in getDigits() layout.
+   * \param c       column [0..getColumnCount()-1].
+   * eturn the column in getColumn() format, 0 if c is out of range.
+   */
+  uint8_t getDigitsColumn(const uint8_t *digits, uint16_t c);
+  /** @} */
+
   //--------------------------------------------------------------
   /** \name Methods for managing specific devices or display buffers.
    * @{
@@ -1091,6 +1229,11 @@ private:
 
   void setModuleParameters(moduleType_t mod);   // setup parameters based on module type
 
+  // raster helpers, bit n of value/mask is column (row) n of the device
+  void rasterRow(uint8_t buf, uint8_t r, uint8_t value, uint8_t mask);    // masked write along a row
+  void rasterColumn(uint8_t buf, uint8_t c, uint8_t value, uint8_t mask); // masked write along a column
+  bool rasterRect(int16_t r1, int16_t c1, int16_t r2, int16_t c2, bool state); // fillRect() without the update
+
   // _hwDigRev switched function for internal use
   bool copyC(uint8_t buf, uint8_t cSrc, uint8_t cDest);
   bool copyR(uint8_t buf, uint8_t rSrc, uint8_t rDest);
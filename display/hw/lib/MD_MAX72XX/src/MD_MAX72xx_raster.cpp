@@ -0,0 +1,339 @@
+/*
+MD_MAX72xx - Library for using a MAX7219/7221 LED matrix controller
+
+See header file for comments
+
+This file contains methods that draw 2D primitives (spans, rectangles,
+lines and bitmap blits) on the pixel field. Each call clips its coordinates
+once and then works on whole digit bytes per device, instead of one
+setPoint() per pixel. It also gives raw access to the digit registers
+(getDigits/setDigits) for compositing whole frames.
+
+Copyright (C) 2012-14 Marco Colli. All rights reserved.
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+#include "MD_MAX72xx.h"
+#include "MD_MAX72xx_lib.h"
+
+/**
+ * \file
+ * \brief Implements raster (span, rectangle, line and blit) methods
+ */
+
+// Bits lo..hi of a byte set, 0 <= lo <= hi <= 7
+static inline uint8_t spanMask(uint8_t lo, uint8_t hi)
+{
+  return (uint8_t)((0xff >> (7 - hi)) & (0xff << lo));
+}
+
+// Transpose an 8x8 bit block held one byte per line: bit j of byte i moves
+// to bit i of byte j.
+static uint64_t transpose8(uint64_t x)
+{
+  uint64_t t;
+
+  t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+  x ^= t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+  x ^= t ^ (t << 14);
+  t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+  x ^= t ^ (t << 28);
+
+  return(x);
+}
+
+void MD_MAX72XX::rasterRow(uint8_t buf, uint8_t r, uint8_t value, uint8_t mask)
+// Pixels of row r in device buf where mask is set take the bit from value.
+// Bit n of value/mask is device column n. Only digits that change are marked.
+{
+  if (_hwDigRows)
+  {
+    uint8_t d = HW_ROW(r);
+    if (_hwRevCols)
+    {
+      value = bitReverse(value);
+      mask = bitReverse(mask);
+    }
+    uint8_t v = (_matrix[buf].dig[d] & ~mask) | (value & mask);
+
+    if (v != _matrix[buf].dig[d])
+    {
+      _matrix[buf].dig[d] = v;
+      bitSet(_matrix[buf].changed, d);
+    }
+  }
+  else
+  {
+    uint8_t b = HW_COL(r);
+
+    for (uint8_t c = 0; mask != 0; c++, mask >>= 1, value >>= 1)
+    {
+      if (!(mask & 1)) continue;
+
+      uint8_t d = HW_ROW(c);
+      uint8_t v = (value & 1) ? (_matrix[buf].dig[d] | (1 << b)) : (_matrix[buf].dig[d] & ~(1 << b));
+
+      if (v != _matrix[buf].dig[d])
+      {
+        _matrix[buf].dig[d] = v;
+        bitSet(_matrix[buf].changed, d);
+      }
+    }
+  }
+}
+
+void MD_MAX72XX::rasterColumn(uint8_t buf, uint8_t c, uint8_t value, uint8_t mask)
+// Pixels of device column c in device buf where mask is set take the bit
+// from value. Bit n of value/mask is row n. Only digits that change are marked.
+{
+  if (!_hwDigRows)
+  {
+    uint8_t d = HW_ROW(c);
+    if (_hwRevCols)
+    {
+      value = bitReverse(value);
+      mask = bitReverse(mask);
+    }
+    uint8_t v = (_matrix[buf].dig[d] & ~mask) | (value & mask);
+
+    if (v != _matrix[buf].dig[d])
+    {
+      _matrix[buf].dig[d] = v;
+      bitSet(_matrix[buf].changed, d);
+    }
+  }
+  else
+  {
+    uint8_t b = HW_COL(c);
+
+    for (uint8_t r = 0; mask != 0; r++, mask >>= 1, value >>= 1)
+    {
+      if (!(mask & 1)) continue;
+
+      uint8_t d = HW_ROW(r);
+      uint8_t v = (value & 1) ? (_matrix[buf].dig[d] | (1 << b)) : (_matrix[buf].dig[d] & ~(1 << b));
+
+      if (v != _matrix[buf].dig[d])
+      {
+        _matrix[buf].dig[d] = v;
+        bitSet(_matrix[buf].changed, d);
+      }
+    }
+  }
+}
+
+bool MD_MAX72XX::rasterRect(int16_t r1, int16_t c1, int16_t r2, int16_t c2, bool state)
+// Filled rectangle without the final flush; false if entirely clipped
+{
+  int16_t t;
+
+  if (r1 > r2) { t = r1; r1 = r2; r2 = t; }
+  if (c1 > c2) { t = c1; c1 = c2; c2 = t; }
+
+  // clip once
+  if (r1 < 0) r1 = 0;
+  if (c1 < 0) c1 = 0;
+  if (r2 > ROW_SIZE - 1) r2 = ROW_SIZE - 1;
+  if (c2 > (int16_t)getColumnCount() - 1) c2 = getColumnCount() - 1;
+  if (r1 > r2 || c1 > c2) return(false);
+
+  uint8_t value = state ? 0xff : 0;
+  uint8_t rows = spanMask(r1, r2);
+
+  for (uint8_t buf = c1 / COL_SIZE; buf <= c2 / COL_SIZE; buf++)
+  {
+    // columns of this device inside the rectangle
+    uint8_t lo = (buf == c1 / COL_SIZE) ? c1 % COL_SIZE : 0;
+    uint8_t hi = (buf == c2 / COL_SIZE) ? c2 % COL_SIZE : COL_SIZE - 1;
+
+    // one byte operation per digit, whichever way digits run
+    if (_hwDigRows)
+    {
+      uint8_t cols = spanMask(lo, hi);
+      for (uint8_t r = r1; r <= r2; r++)
+        rasterRow(buf, r, value, cols);
+    }
+    else
+    {
+      for (uint8_t c = lo; c <= hi; c++)
+        rasterColumn(buf, c, value, rows);
+    }
+  }
+
+  return(true);
+}
+
+bool MD_MAX72XX::fillRect(int16_t r1, int16_t c1, int16_t r2, int16_t c2, bool state)
+{
+  bool b = rasterRect(r1, c1, r2, c2, state);
+
+  if (b && _updateEnabled) flushBufferAll();
+
+  return(b);
+}
+
+bool MD_MAX72XX::drawRect(int16_t r1, int16_t c1, int16_t r2, int16_t c2, bool state)
+{
+  bool b = false;
+
+  b |= rasterRect(r1, c1, r1, c2, state);
+  b |= rasterRect(r2, c1, r2, c2, state);
+  b |= rasterRect(r1, c1, r2, c1, state);
+  b |= rasterRect(r1, c2, r2, c2, state);
+
+  if (b && _updateEnabled) flushBufferAll();
+
+  return(b);
+}
+
+bool MD_MAX72XX::drawLine(int16_t r1, int16_t c1, int16_t r2, int16_t c2, bool state)
+// Bresenham, emitting each straight run of pixels as one span
+{
+  int16_t dc = (c2 > c1) ? c2 - c1 : c1 - c2;
+  int16_t dr = (r2 > r1) ? r1 - r2 : r2 - r1;   // negative
+  int16_t sc = (c1 < c2) ? 1 : -1;
+  int16_t sr = (r1 < r2) ? 1 : -1;
+  int16_t err = dc + dr;
+  int16_t runR = r1, runC = c1;
+  bool b = false;
+
+  for (;;)
+  {
+    if (r1 == r2 && c1 == c2) break;
+
+    int16_t e2 = 2 * err;
+    bool stepC = (e2 >= dr);
+    bool stepR = (e2 <= dc);
+
+    // a run ends when the line moves on the other axis
+    if ((dc >= -dr) ? stepR : stepC)
+    {
+      b |= rasterRect(runR, runC, r1, c1, state);
+      runR = r1 + (stepR ? sr : 0);
+      runC = c1 + (stepC ? sc : 0);
+    }
+    if (stepC) { err += dr; c1 += sc; }
+    if (stepR) { err += dc; r1 += sr; }
+  }
+  b |= rasterRect(runR, runC, r1, c1, state);
+
+  if (b && _updateEnabled) flushBufferAll();
+
+  return(b);
+}
+
+bool MD_MAX72XX::blit(int16_t c, const uint8_t *data, uint16_t width, const uint8_t *mask)
+{
+  if (data == NULL || width == 0) return(false);
+
+  // clip once
+  int16_t first = (c < 0) ? -c : 0;
+  int32_t last = (int32_t)c + width - 1;
+  if (last > (int32_t)getColumnCount() - 1) last = getColumnCount() - 1;
+  if (c + first > last) return(false);
+
+  for (uint8_t buf = (c + first) / COL_SIZE; buf <= last / COL_SIZE; buf++)
+  {
+    // gather this device's 8 columns (zero mask outside the bitmap)
+    uint64_t v = 0, m = 0;
+    int16_t col0 = buf * COL_SIZE;
+
+    for (uint8_t k = 0; k < COL_SIZE; k++)
+    {
+      int16_t i = col0 + k - c;
+
+      if (col0 + k < c + first || col0 + k > last) continue;
+      v |= (uint64_t)data[i] << (8 * k);
+      m |= (uint64_t)(mask ? mask[i] : 0xff) << (8 * k);
+    }
+
+    if (_hwDigRows)
+    {
+      // digits are rows: turn the 8 columns into 8 rows in one go
+      v = transpose8(v);
+      m = transpose8(m);
+      for (uint8_t r = 0; r < ROW_SIZE; r++)
+        if ((uint8_t)(m >> (8 * r)))
+          rasterRow(buf, r, (uint8_t)(v >> (8 * r)), (uint8_t)(m >> (8 * r)));
+    }
+    else
+    {
+      for (uint8_t k = 0; k < COL_SIZE; k++)
+        if ((uint8_t)(m >> (8 * k)))
+          rasterColumn(buf, k, (uint8_t)(v >> (8 * k)), (uint8_t)(m >> (8 * k)));
+    }
+  }
+
+  if (_updateEnabled) flushBufferAll();
+
+  return(true);
+}
+
+void MD_MAX72XX::getDigits(uint8_t *digits)
+{
+  for (uint8_t d = 0; d < ROW_SIZE; d++)
+    for (uint8_t buf = 0; buf <= LAST_BUFFER; buf++)
+      digits[d * _maxDevices + buf] = _matrix[buf].dig[d];
+}
+
+void MD_MAX72XX::setDigits(const uint8_t *digits, const uint8_t *mask)
+{
+  for (uint8_t d = 0; d < ROW_SIZE; d++)
+  {
+    for (uint8_t buf = 0; buf <= LAST_BUFFER; buf++)
+    {
+      uint16_t i = d * _maxDevices + buf;
+      uint8_t m = mask ? mask[i] : 0xff;
+      uint8_t v = (_matrix[buf].dig[d] & ~m) | (digits[i] & m);
+
+      if (v != _matrix[buf].dig[d])
+      {
+        _matrix[buf].dig[d] = v;
+        bitSet(_matrix[buf].changed, d);
+      }
+    }
+  }
+
+  if (_updateEnabled) flushBufferAll();
+}
+
+uint8_t MD_MAX72XX::getDigitsColumn(const uint8_t *digits, uint16_t c)
+// same mapping as getColumn(), on the snapshot
+{
+  uint8_t buf = c / COL_SIZE;
+
+  if (buf > LAST_BUFFER) return(0);
+  c %= COL_SIZE;
+
+  if (_hwDigRows)
+  {
+    uint8_t mask = 1 << HW_COL(c);
+    uint8_t value = 0;
+
+    for (uint8_t i = 0; i < ROW_SIZE; i++)
+      if (digits[HW_ROW(i) * _maxDevices + buf] & mask)
+        bitSet(value, i);
+
+    return(value);
+  }
+
+  uint8_t value = digits[HW_ROW(c) * _maxDevices + buf];
+
+  return(_hwRevCols ? bitReverse(value) : value);
+}
@@ -0,0 +1,282 @@
+#include "assets.h"
+
+#include <ctype.h>
+#include <string.h>
+
+#ifdef ESP_PLATFORM
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+#endif
+
+// --- SLOT BACKEND ----------------------------------------------------------
+// Two data partitions on the device. The host build has no flash, so two
+// RAM buffers stand in for them (erase = fill with 0xFF, like NOR flash).
+
+constexpr uint32_t SECTOR_SIZE = 4096;
+
+#ifdef ESP_PLATFORM
+static const char *SLOT_LABELS[2] = { "assets_a", "assets_b" };
+static const esp_partition_t *slotPart[2];
+static esp_partition_mmap_handle_t slotHandle[2];
+
+static bool slotOpen(uint8_t s) {
+  if (!slotPart[s]) {
+    slotPart[s] = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                           (esp_partition_subtype_t)ASSET_SUBTYPE, SLOT_LABELS[s]);
+  }
+  return slotPart[s] && slotPart[s]->size >= ASSET_SLOT_SIZE;
+}
+
+static const uint8_t *slotMap(uint8_t s) {
+  if (!slotOpen(s)) return nullptr;
+  const void *p = nullptr;
+  if (esp_partition_mmap(slotPart[s], 0, ASSET_SLOT_SIZE, ESP_PARTITION_MMAP_DATA, &p, &slotHandle[s]) != ESP_OK) {
+    return nullptr;
+  }
+  return (const uint8_t *)p;
+}
+
+static void slotUnmap(uint8_t s) { esp_partition_munmap(slotHandle[s]); }
+
+static bool slotErase(uint8_t s, uint32_t offset, uint32_t len) {
+  return slotOpen(s) && esp_partition_erase_range(slotPart[s], offset, len) == ESP_OK;
+}
+
+static bool slotWrite(uint8_t s, uint32_t offset, const void *data, uint32_t len) {
+  return slotOpen(s) && esp_partition_write(slotPart[s], offset, data, len) == ESP_OK;
+}
+
+static bool slotRead(uint8_t s, uint32_t offset, void *data, uint32_t len) {
+  return slotOpen(s) && esp_partition_read(slotPart[s], offset, data, len) == ESP_OK;
+}
+
+uint32_t crc32Update(uint32_t crc, const uint8_t *data, uint32_t len) {
+  return esp_rom_crc32_le(crc, data, len);
+}
+#else
+static uint8_t hostSlots[2][ASSET_SLOT_SIZE];
+static bool hostSlotsErased = false;
+
+static uint8_t *hostSlot(uint8_t s) {
+  if (!hostSlotsErased) {
+    memset(hostSlots, 0xFF, sizeof(hostSlots));
+    hostSlotsErased = true;
+  }
+  return hostSlots[s];
+}
+
+static const uint8_t *slotMap(uint8_t s) { return hostSlot(s); }
+static void slotUnmap(uint8_t) {}
+
+static bool slotErase(uint8_t s, uint32_t offset, uint32_t len) {
+  memset(hostSlot(s) + offset, 0xFF, len);
+  return true;
+}
+
+static bool slotWrite(uint8_t s, uint32_t offset, const void *data, uint32_t len) {
+  const uint8_t *src = (const uint8_t *)data;
+  uint8_t *dst = hostSlot(s) + offset;
+  for (uint32_t i = 0; i < len; i++) dst[i] &= src[i];  // programming only clears bits
+  return true;
+}
+
+static bool slotRead(uint8_t s, uint32_t offset, void *data, uint32_t len) {
+  memcpy(data, hostSlot(s) + offset, len);
+  return true;
+}
+
+// Same result as zlib's crc32() / esp_rom_crc32_le()
+uint32_t crc32Update(uint32_t crc, const uint8_t *data, uint32_t len) {
+  crc = ~crc;
+  while (len--) {
+    crc ^= *data++;
+    for (uint8_t k = 0; k < 8; k++) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+  }
+  return ~crc;
+}
+#endif
+
+// --- MOUNTED BUNDLE --------------------------------------------------------
+static const uint8_t *bundle = nullptr;   // mapped active slot
+static int8_t activeSlot = -1;
+static BitmapFont bundleFonts[FONT_COUNT];
+static const BitmapFont *fontTable[FONT_COUNT];
+
+static bool validBundle(const uint8_t *base) {
+  const AssetHeader *h = (const AssetHeader *)base;
+  if (h->magic != ASSET_MAGIC || h->version != ASSET_VERSION) return false;
+  if (h->sequence == ASSET_SEQ_UNSET) return false;
+  if (h->size > ASSET_SLOT_SIZE || h->size < sizeof(AssetHeader) + h->count * sizeof(AssetEntry)) return false;
+  if (crc32Update(0, base + sizeof(AssetHeader), h->size - sizeof(AssetHeader)) != h->crc32) return false;
+
+  const AssetEntry *e = (const AssetEntry *)(base + sizeof(AssetHeader));
+  for (uint16_t i = 0; i < h->count; i++) {
+    if (e[i].offset > h->size || e[i].length > h->size - e[i].offset) return false;
+  }
+  return true;
+}
+
+static void loadFonts() {
+  for (uint8_t i = 0; i < FONT_COUNT; i++) {
+    fontTable[i] = FONTS[i];
+    char name[ASSET_NAME_LEN] = {};
+    for (uint8_t c = 0; c < ASSET_NAME_LEN - 1 && FONTS[i]->name[c]; c++) {
+      name[c] = toupper(FONTS[i]->name[c]);  // bundle names are uppercase: "5X7"
+    }
+    AssetRef ref = assetFind(name, ASSET_FONT);
+    if (!ref || ref.length < sizeof(AssetFont)) continue;
+
+    const AssetFont *f = (const AssetFont *)ref.data;
+    if (f->width == 0 || f->width > 15 || f->height == 0 || f->height > 8) continue;
+    uint32_t bitsLen = (FONT_GLYPHS * f->width * f->height + 7) / 8 + 1;
+    if (ref.length < sizeof(AssetFont) + bitsLen + FONT_GLYPHS) continue;
+
+    const uint8_t *bits = ref.data + sizeof(AssetFont);
+    bundleFonts[i] = { FONTS[i]->name, f->width, f->height, f->yOffset, f->spaceWidth,
+                       bits, bits + bitsLen };
+    fontTable[i] = &bundleFonts[i];
+  }
+}
+
+static void mountSlot(int8_t slot, const uint8_t *base) {
+  if (activeSlot >= 0 && activeSlot != slot) slotUnmap(activeSlot);
+  activeSlot = slot;
+  bundle = base;
+  loadFonts();
+}
+
+bool assetsMount() {
+  const uint8_t *base[2] = { nullptr, nullptr };
+  int8_t best = -1;
+  for (uint8_t s = 0; s < 2; s++) {
+    base[s] = slotMap(s);
+    if (!base[s]) continue;
+    if (!validBundle(base[s])) {
+      slotUnmap(s);
+      base[s] = nullptr;
+      continue;
+    }
+    if (best < 0 || ((const AssetHeader *)base[s])->sequence > ((const AssetHeader *)base[best])->sequence) {
+      best = s;
+    }
+  }
+  for (uint8_t s = 0; s < 2; s++) {
+    if (base[s] && s != best) slotUnmap(s);
+  }
+
+  activeSlot = -1;
+  bundle = nullptr;
+  if (best >= 0) mountSlot(best, base[best]);
+  else loadFonts();
+  return bundle != nullptr;
+}
+
+bool assetsMounted() { return bundle != nullptr; }
+char assetsSlot() { return activeSlot < 0 ? '-' : 'A' + activeSlot; }
+const AssetHeader *assetsHeader() { return (const AssetHeader *)bundle; }
+
+AssetRef assetFind(const char *name, AssetType type) {
+  AssetRef ref;
+  if (!bundle) return ref;
+
+  const AssetHeader *h = assetsHeader();
+  const AssetEntry *e = (const AssetEntry *)(bundle + sizeof(AssetHeader));
+  int lo = 0, hi = (int)h->count - 1;
+  while (lo <= hi) {
+    int mid = (lo + hi) / 2;
+    int c = strncmp(name, e[mid].name, ASSET_NAME_LEN);
+    if (c == 0) {
+      if (e[mid].type == type) {
+        ref.data = bundle + e[mid].offset;
+        ref.length = e[mid].length;
+      }
+      return ref;
+    }
+    if (c < 0) hi = mid - 1;
+    else lo = mid + 1;
+  }
+  return ref;
+}
+
+const char *assetText(const char *name, const char *fallback) {
+  AssetRef ref = assetFind(name, ASSET_TEXT);
+  if (!ref || ref.length == 0 || ref.data[ref.length - 1] != 0) return fallback;
+  return (const char *)ref.data;
+}
+
+const BitmapFont &assetFontOr(uint8_t i) {
+  if (!fontTable[i]) fontTable[i] = FONTS[i];
+  return *fontTable[i];
+}
+
+// --- UPLOAD ----------------------------------------------------------------
+struct Upload {
+  bool active = false;
+  uint8_t slot = 0;
+  uint32_t size = 0;
+  uint32_t crc = 0;
+  uint32_t next = 0;       // next expected offset, chunks must arrive in order
+  uint32_t erasedTo = 0;   // sectors are erased lazily as data reaches them
+};
+
+static Upload upload;
+
+const char *assetUploadBegin(uint32_t size, uint32_t crc) {
+  if (size < sizeof(AssetHeader) || size > ASSET_SLOT_SIZE) return "SIZE";
+  upload = Upload();
+  upload.active = true;
+  upload.slot = activeSlot == 0 ? 1 : 0;
+  upload.size = size;
+  upload.crc = crc;
+  return nullptr;
+}
+
+const char *assetUploadData(uint32_t offset, const uint8_t *data, uint32_t len) {
+  if (!upload.active) return "NO UPLOAD";
+  if (offset != upload.next) return "OFFSET";
+  if (len > upload.size - offset) return "SIZE";
+
+  while (upload.erasedTo < offset + len) {
+    if (!slotErase(upload.slot, upload.erasedTo, SECTOR_SIZE)) return "ERASE";
+    upload.erasedTo += SECTOR_SIZE;
+  }
+  if (!slotWrite(upload.slot, offset, data, len)) return "WRITE";
+  upload.next += len;
+  return nullptr;
+}
+
+const char *assetUploadCommit(void (*beforeSwap)()) {
+  if (!upload.active) return "NO UPLOAD";
+  if (upload.next != upload.size) return "INCOMPLETE";
+
+  AssetHeader h;
+  if (!slotRead(upload.slot, 0, &h, sizeof(h))) return "READ";
+  if (h.magic != ASSET_MAGIC || h.version != ASSET_VERSION || h.size != upload.size) return "HEADER";
+  if (h.sequence != ASSET_SEQ_UNSET) return "HEADER";
+
+  uint8_t chunk[256];
+  uint32_t crc = 0;
+  for (uint32_t off = sizeof(AssetHeader); off < upload.size; off += sizeof(chunk)) {
+    uint32_t n = upload.size - off < sizeof(chunk) ? upload.size - off : sizeof(chunk);
+    if (!slotRead(upload.slot, off, chunk, n)) return "READ";
+    crc = crc32Update(crc, chunk, n);
+  }
+  if (crc != upload.crc || crc != h.crc32) return "CRC";
+
+  // Erased flash reads 0xFFFFFFFF here, so the sequence can be programmed in place
+  uint32_t seq = bundle ? assetsHeader()->sequence + 1 : 1;
+  if (!slotWrite(upload.slot, offsetof(AssetHeader, sequence), &seq, sizeof(seq))) return "WRITE";
+
+  const uint8_t *base = slotMap(upload.slot);
+  if (!base || !validBundle(base)) {
+    if (base) slotUnmap(upload.slot);
+    upload.active = false;
+    return "VERIFY";
+  }
+  if (beforeSwap) beforeSwap();
+  mountSlot(upload.slot, base);
+  upload.active = false;
+  return nullptr;
+}
+
+void assetUploadAbort() { upload.active = false; }
@@ -1,20 +1,28 @@
 #include <Arduino.h>
 #include <MD_MAX72xx.h>
 #include <SPI.h>
+#include "displayConfig.h"
+#include "fonts.h"
+#include "assets.h"
+#include "channels.h"
+#include "mirror.h"
+#include "overlay.h"
+#include "strip.h"
+#include "patternTask.h"
+#include "ledPatterns.h"
 
 // --- DISPLAY CONFIGURATION -------------------------------------------------
-#define HARDWARE_TYPE MD_MAX72XX::FC16_HW
-#define MAX_DEVICES 4
-#define CLK_PIN   0   // D0
-#define DATA_PIN  2   // D2 (DIN)
-#define CS_PIN    1   // D1
-
+// Pins and module type live in displayConfig.h
 MD_MAX72XX mx = MD_MAX72XX(HARDWARE_TYPE, DATA_PIN, CLK_PIN, CS_PIN, MAX_DEVICES);
 constexpr int DISPLAY_WIDTH = MAX_DEVICES * 8;
+constexpr int MAX_LINE = 320;      // longest serial command (STATE LOAD lines)
+#ifndef BOOT_DELAY_MS
+#define BOOT_DELAY_MS 500          // lets USB CDC enumerate before the banner
+#endif
 
 // --- STATE & HELPERS -------------------------------------------------------
-enum Pattern { PATTERN_NONE, PATTERN_SNAKE, PATTERN_THINKING, PATTERN_FINISH, PATTERN_REMOVE_FIGURE, PATTERN_ERROR, PATTERN_TEXT };
-enum ScrollDirection { SCROLL_NONE, SCROLL_LEFT, SCROLL_RIGHT };
+enum Pattern { PATTERN_NONE, PATTERN_SNAKE, PATTERN_THINKING, PATTERN_FINISH, PATTERN_REMOVE_FIGURE, PATTERN_ERROR, PATTERN_TEXT, PATTERN_FAREWELL, PATTERN_SELFTEST, PATTERN_SPRITE, PATTERN_STRIP, PATTERN_PROGRESS };
+enum ScrollDirection { SCROLL_NONE, SCROLL_LEFT, SCROLL_RIGHT, SCROLL_LOOP };
 
 struct Point { int8_t x, y; };
 
@@ -24,6 +32,15 @@ struct SnakeState {
   int8_t dirX, dirY;
 };
 
+// PROGRESS6: one segment per token placed on the reader
+constexpr uint8_t TOKEN_COUNT = 6;
+
+struct ProgressState {
+  uint8_t stage[TOKEN_COUNT];          // index into SEGMENT_STAGES
+  bool on[TOKEN_COUNT];
+  unsigned long nextStep[TOKEN_COUNT]; // fill animation
+};
+
 struct PatternState {
   Pattern current = PATTERN_NONE;
   uint8_t stage = 0;       // sub-state inside a pattern
@@ -32,120 +49,150 @@ struct PatternState {
   int16_t var2 = 0;        // reusable
   unsigned long lastStep = 0;
   SnakeState snake;        // For SNAKE state
-  String customText = "";  // For TEXT pattern
-  ScrollDirection scrollDir = SCROLL_NONE; // For TEXT pattern
+  ProgressState progress;  // For PROGRESS6
+  String customText = "";  // For TEXT pattern; sprite name for SPRITE
+  ScrollDirection scrollDir = SCROLL_NONE; // For TEXT and STRIP patterns
+  const BitmapFont *font = &FONT_5x7;      // For TEXT pattern
+  bool proportional = false;               // For TEXT pattern (FIT mode)
+  int16_t textPx = 0;                      // For TEXT pattern, measured once; STRIP width
 };
 
 PatternState ps;
 uint8_t gSpeed = 5;        // 0-10 (higher = faster)
 uint8_t gBrightness = 7;   // 0-15
 
-// Full 5x7 Font
-const uint8_t FONT_5x7[][5] = {
-  {0x00, 0x00, 0x00, 0x00, 0x00}, // space
-  {0x00, 0x00, 0x5F, 0x00, 0x00}, // !
-  {0x00, 0x07, 0x00, 0x07, 0x00}, // "
-  {0x14, 0x7F, 0x14, 0x7F, 0x14}, // #
-  {0x24, 0x2A, 0x7F, 0x2A, 0x12}, // $
-  {0x23, 0x13, 0x08, 0x64, 0x62}, // %
-  {0x36, 0x49, 0x55, 0x22, 0x50}, // &
-  {0x00, 0x05, 0x03, 0x00, 0x00}, // '
-  {0x00, 0x1C, 0x22, 0x41, 0x00}, // (
-  {0x00, 0x41, 0x22, 0x1C, 0x00}, // )
-  {0x14, 0x08, 0x3E, 0x08, 0x14}, // *
-  {0x08, 0x08, 0x3E, 0x08, 0x08}, // +
-  {0x00, 0x50, 0x30, 0x00, 0x00}, // ,
-  {0x08, 0x08, 0x08, 0x08, 0x08}, // -
-  {0x00, 0x60, 0x60, 0x00, 0x00}, // .
-  {0x20, 0x10, 0x08, 0x04, 0x02}, // /
-  {0x3E, 0x51, 0x49, 0x45, 0x3E}, // 0
-  {0x00, 0x42, 0x7F, 0x40, 0x00}, // 1
-  {0x42, 0x61, 0x51, 0x49, 0x46}, // 2
-  {0x21, 0x41, 0x45, 0x4B, 0x31}, // 3
-  {0x18, 0x14, 0x12, 0x7F, 0x10}, // 4
-  {0x27, 0x45, 0x45, 0x45, 0x39}, // 5
-  {0x3C, 0x4A, 0x49, 0x49, 0x30}, // 6
-  {0x01, 0x71, 0x09, 0x05, 0x03}, // 7
-  {0x36, 0x49, 0x49, 0x49, 0x36}, // 8
-  {0x06, 0x49, 0x49, 0x29, 0x1E}, // 9
-  {0x00, 0x36, 0x36, 0x00, 0x00}, // :
-  {0x00, 0x56, 0x36, 0x00, 0x00}, // ;
-  {0x08, 0x14, 0x22, 0x41, 0x00}, // <
-  {0x14, 0x14, 0x14, 0x14, 0x14}, // =
-  {0x00, 0x41, 0x22, 0x14, 0x08}, // >
-  {0x02, 0x01, 0x51, 0x09, 0x06}, // ?
-  {0x32, 0x49, 0x79, 0x41, 0x3E}, // @
-  {0x7E, 0x11, 0x11, 0x11, 0x7E}, // A
-  {0x7F, 0x49, 0x49, 0x49, 0x36}, // B
-  {0x3E, 0x41, 0x41, 0x41, 0x22}, // C
-  {0x7F, 0x41, 0x41, 0x22, 0x1C}, // D
-  {0x7F, 0x49, 0x49, 0x49, 0x41}, // E
-  {0x7F, 0x09, 0x09, 0x09, 0x01}, // F
-  {0x3E, 0x41, 0x49, 0x49, 0x7A}, // G
-  {0x7F, 0x08, 0x08, 0x08, 0x7F}, // H
-  {0x00, 0x41, 0x7F, 0x41, 0x00}, // I
-  {0x20, 0x40, 0x41, 0x3F, 0x01}, // J
-  {0x7F, 0x08, 0x14, 0x22, 0x41}, // K
-  {0x7F, 0x40, 0x40, 0x40, 0x40}, // L
-  {0x7F, 0x02, 0x0C, 0x02, 0x7F}, // M
-  {0x7F, 0x04, 0x08, 0x10, 0x7F}, // N
-  {0x3E, 0x41, 0x41, 0x41, 0x3E}, // O
-  {0x7F, 0x09, 0x09, 0x09, 0x06}, // P
-  {0x3E, 0x41, 0x51, 0x21, 0x5E}, // Q
-  {0x7F, 0x09, 0x19, 0x29, 0x46}, // R
-  {0x46, 0x49, 0x49, 0x49, 0x31}, // S
-  {0x01, 0x01, 0x7F, 0x01, 0x01}, // T
-  {0x3F, 0x40, 0x40, 0x40, 0x3F}, // U
-  {0x1F, 0x20, 0x40, 0x20, 0x1F}, // V
-  {0x3F, 0x40, 0x38, 0x40, 0x3F}, // W
-  {0x63, 0x14, 0x08, 0x14, 0x63}, // X
-  {0x07, 0x08, 0x70, 0x08, 0x07}, // Y
-  {0x61, 0x51, 0x49, 0x45, 0x43}, // Z
-  {0x00, 0x7F, 0x41, 0x41, 0x00}, // [
-  {0x02, 0x04, 0x08, 0x10, 0x20}, // \ (backslash)
-  {0x00, 0x41, 0x41, 0x7F, 0x00}, // ]
-  {0x04, 0x02, 0x01, 0x02, 0x04}, // ^
-  {0x40, 0x40, 0x40, 0x40, 0x40}  // _
-};
+// Width including the 1px gap after the last glyph
+int textWidth(const char *s, const BitmapFont &f = assetFontOr(0), bool proportional = false) {
+  int w = 0;
+  for (; *s; s++) w += glyphAdvance(f, glyphIndex(*s), proportional);
+  return w;
+}
 
-int textWidth(const String &s) { return s.length() * 6; }
+int textWidth(const String &s) { return textWidth(s.c_str()); }
 
-const uint8_t* glyphFor(char c) {
-  if (c < 32 || c > 95) return FONT_5x7[0];
-  return FONT_5x7[c - 32];
-}
+int drawGlyph(int x, int y, char c, const BitmapFont &f, bool proportional) {
+  uint8_t g = glyphIndex(c);
+  uint8_t advance = glyphAdvance(f, g, proportional);
+  if (x >= DISPLAY_WIDTH || x + advance <= 0) return advance;
 
-void drawChar5x7(int x, int y, char c) {
-  const uint8_t* g = glyphFor(c);
-  for (int col = 0; col < 5; col++) {
-    uint8_t bits = g[col];
-    for (int row = 0; row < 7; row++) {
+  uint8_t first = 0, last = f.width - 1;
+  if (proportional) {
+    if (f.spans[g] == 0xFF) return advance;
+    first = f.spans[g] >> 4;
+    last = f.spans[g] & 0x0F;
+  }
+  for (uint8_t col = first; col <= last; col++) {
+    uint8_t bits = fontColumn(f, g, col);
+    int xx = x + col - first;
+    if (xx < 0 || xx >= DISPLAY_WIDTH) continue;
+    for (int row = 0; row < f.height; row++) {
       // Standard orientation: LSB is top (row 0)
       bool on = bits & (1 << row);
-      int xx = x + col;
-      int yy = y + row;
-      if (xx >= 0 && xx < DISPLAY_WIDTH && yy >= 0 && yy < 8) {
+      int yy = y + f.yOffset + row;
+      if (yy >= 0 && yy < 8) {
         mx.setPoint(7 - yy, xx, on); // flip vertically to fix orientation
       }
     }
   }
+  return advance;
 }
 
-void drawText(int x, int y, const String &s) {
+void drawText(int x, int y, const char *s, const BitmapFont &f = assetFontOr(0), bool proportional = false) {
   int cursor = x;
-  for (int i = 0; i < s.length(); i++) {
-    drawChar5x7(cursor, y, s[i]);
-    cursor += 6; // 5px + 1px space
+  for (; *s && cursor < DISPLAY_WIDTH; s++) {
+    cursor += drawGlyph(cursor, y, *s, f, proportional);
   }
 }
 
-void drawCentered(const String &s) {
-  int w = textWidth(s);
+void drawText(int x, int y, const String &s) { drawText(x, y, s.c_str()); }
+
+void drawCentered(const char *s, const BitmapFont &f = assetFontOr(0), bool proportional = false) {
+  int w = textWidth(s, f, proportional) - 1;
   int x = (DISPLAY_WIDTH - w) / 2;
   if (x < 0) x = 0;
   mx.clear();
-  drawText(x, 0, s);
-  mx.update();
+  drawText(x, 0, s, f, proportional);
+  flushFrame();
+}
+
+void drawCentered(const String &s) { drawCentered(s.c_str()); }
+
+// Library columns have the top row in bit 7
+uint8_t reverseBits(uint8_t b) {
+  b = (b & 0xF0) >> 4 | (b & 0x0F) << 4;
+  b = (b & 0xCC) >> 2 | (b & 0x33) << 2;
+  b = (b & 0xAA) >> 1 | (b & 0x55) << 1;
+  return b;
+}
+
+// Column bytes with LSB = top row, as stored in fonts, asset sprites and
+// strips. Only the visible part is touched, however long `cols` is.
+void drawColumns(int x, const uint8_t *cols, int count) {
+  int first = x < 0 ? -x : 0;
+  int last = DISPLAY_WIDTH - x < count ? DISPLAY_WIDTH - x : count;
+  uint8_t window[DISPLAY_WIDTH];
+  for (int i = first; i < last; i++) window[i - first] = reverseBits(cols[i]);
+  if (last > first) mx.blit(x + first, window, last - first);
+}
+
+// Strip window for the TEXT scroll engine: at x like text, or for LOOP
+// starting at strip column x, wrapping around without a gap
+void drawStrip(int x) {
+  const uint8_t *cols = stripColumns();
+  int w = ps.textPx;
+  if (ps.scrollDir != SCROLL_LOOP) {
+    drawColumns(x, cols, w);
+    return;
+  }
+  for (int xx = 0; xx < DISPLAY_WIDTH; xx++) {
+    mx.setColumn(xx, reverseBits(cols[x]));
+    if (++x == w) x = 0;
+  }
+}
+
+// --- FIT-TO-WIDTH ----------------------------------------------------------
+// Picks the largest proportional font that shows the message without
+// scrolling. Results are cached per message, since the service keeps
+// sending the same few strings.
+struct TextFit {
+  uint32_t key = 0;        // FNV-1a of the message, 0 = empty slot
+  uint8_t font = 0;        // index into FONTS
+  int16_t width = 0;       // textWidth() in that font
+  bool fits = false;
+};
+
+TextFit fitCache[4];
+uint8_t fitCacheNext = 0;
+
+uint32_t textKey(const char *s) {
+  uint32_t h = 2166136261u;
+  for (; *s; s++) h = (h ^ (uint8_t)*s) * 16777619u;
+  return h ? h : 1;
+}
+
+TextFit fitText(const char *s) {
+  uint32_t key = textKey(s);
+  for (const TextFit &c : fitCache) {
+    if (c.key == key) return c;
+  }
+
+  TextFit fit;
+  fit.key = key;
+  for (uint8_t i = 0; i < FONT_COUNT; i++) {
+    fit.font = i;
+    fit.width = textWidth(s, assetFontOr(i), true);
+    fit.fits = fit.width - 1 <= DISPLAY_WIDTH;
+    if (fit.fits) break;
+  }
+  if (!fit.fits) {
+    // Scroll in the most readable font
+    fit.font = 0;
+    fit.width = textWidth(s, assetFontOr(0), true);
+  }
+
+  fitCache[fitCacheNext] = fit;
+  fitCacheNext = (fitCacheNext + 1) % 4;
+  return fit;
 }
 
 int adjustedInterval(int baseMs) {
@@ -156,7 +203,7 @@ int adjustedInterval(int baseMs) {
 
 void clearAll() {
   mx.clear();
-  mx.update();
+  flushFrame();
 }
 
 // --- SNAKE HELPERS ---------------------------------------------------------
@@ -226,48 +273,302 @@ void updateSnakeAI() {
   }
 }
 
+// --- TOKEN PROGRESS --------------------------------------------------------
+// TOKEN <n> ON/OFF only rewrites that segment's precomputed columns and
+// flushes the one or two modules under it, so the segment lights within a
+// few SPI transfers of the command arriving. The fill animation continues
+// from updateProgress().
+constexpr uint8_t SEGMENT_WIDTH = 4;
+constexpr uint8_t SEGMENT_PITCH = 5;
+constexpr uint8_t SEGMENT_X0 = (DISPLAY_WIDTH - (TOKEN_COUNT * SEGMENT_PITCH - 1)) / 2;
+// mx columns (bit 0 = bottom row): empty slot, then filling up from the bottom
+constexpr uint8_t SEGMENT_STAGES[] = { 0x01, 0x07, 0x1F, 0x7F };
+constexpr uint8_t SEGMENT_FULL = sizeof(SEGMENT_STAGES) - 1;
+constexpr unsigned long SEGMENT_STEP_MS = 40;
+
+struct TokenLatency {
+  uint32_t count = 0;
+  uint32_t lastUs = 0, maxUs = 0;
+  uint64_t totalUs = 0;
+};
+
+TokenLatency tokenLatency;       // first byte of a TOKEN line -> segment flushed
+unsigned long lineStartUs = 0;   // micros() when the current command line began
+
+// Only rows that actually change are marked for the next flush
+void paintSegment(uint8_t i) {
+  uint8_t cols[SEGMENT_WIDTH];
+  memset(cols, SEGMENT_STAGES[ps.progress.stage[i]], SEGMENT_WIDTH);
+  mx.blit(SEGMENT_X0 + i * SEGMENT_PITCH, cols, SEGMENT_WIDTH);
+}
+
+void drawSegment(uint8_t i) {
+  uint8_t x = SEGMENT_X0 + i * SEGMENT_PITCH;
+  paintSegment(i);
+
+  if (overlayCount()) {
+    flushFrame();                // overlays need the whole frame composited
+    return;
+  }
+  // One module: flush just that one. Across two, the full flush is cheaper:
+  // it sends each changed row to both in a single transfer.
+  uint8_t first = x / 8, last = (x + SEGMENT_WIDTH - 1) / 8;
+  if (first == last) mx.update(first);
+  else mx.update();
+}
+
+void initProgress() {
+  for (uint8_t i = 0; i < TOKEN_COUNT; i++) {
+    ps.progress.stage[i] = 0;
+    ps.progress.on[i] = false;
+    paintSegment(i);
+  }
+  flushFrame();
+}
+
+void setToken(uint8_t i, bool on) {
+  ProgressState &p = ps.progress;
+  if (p.on[i] == on) return;
+  p.on[i] = on;
+  p.stage[i] = on ? 1 : 0;
+  p.nextStep[i] = millis() + SEGMENT_STEP_MS;
+  drawSegment(i);
+}
+
+// --- COROUTINE PATTERNS ----------------------------------------------------
+// Scroll text once from off-screen right (or from `from`, when resuming)
+// until it has left on the left
+PatternTask scrollOnce(const char *text, int16_t from = DISPLAY_WIDTH) {
+  int w = textWidth(text);
+  for (ps.scrollX = from; ps.scrollX >= -w; ps.scrollX--) {
+    mx.clear();
+    drawText(ps.scrollX, 0, text);
+    flushFrame();
+    co_await sleepFor(adjustedInterval(80));
+  }
+}
+
+PatternTask scrollForever(const char *text, int16_t from = DISPLAY_WIDTH) {
+  co_await scrollOnce(text, from);
+  for (;;) co_await scrollOnce(text);
+}
+
+PatternTask blinkError() {
+  for (;;) {
+    drawCentered("ERROR");
+    co_await sleepFor(adjustedInterval(200));
+    clearAll();
+    co_await sleepFor(adjustedInterval(200));
+  }
+}
+
+// End-of-visit choreography: VOILA -> THANK YOU -> REMOVE FIGURE
+PatternTask farewell() {
+  for (int i = 0; i < 3; i++) {
+    drawCentered(assetText("VOILA", "VOILA"));
+    co_await sleepFor(600);
+    clearAll();
+    co_await sleepFor(150);
+  }
+  const char *thanks = assetText("THANKS", "THANK YOU FOR THE VISIT   ");
+  co_await scrollOnce(thanks);
+  co_await scrollOnce(thanks);
+  for (;;) co_await scrollOnce(assetText("REMOVE_FIGURE", "PLEASE REMOVE FIGURE   "));
+}
+
+// Loop a sprite from the asset bundle; frames are read straight from flash
+PatternTask playSprite(AssetRef ref) {
+  const AssetSprite *sp = (const AssetSprite *)ref.data;
+  const uint8_t *frames = ref.data + sizeof(AssetSprite);
+  int x0 = (DISPLAY_WIDTH - sp->width) / 2;
+  for (uint16_t f = 0;; f = (f + 1) % sp->frameCount) {
+    mx.clear();
+    drawColumns(x0, frames + (uint32_t)f * sp->width, sp->width);
+    flushFrame();
+    co_await sleepFor(sp->frameMs);
+  }
+}
+
+// Every coroutine, built but never resumed, to size its frame. Frame sizes
+// depend on the compiler, so setup() checks them against TASK_FRAME_SIZE on
+// the target rather than trusting the host build.
+struct TaskFrame {
+  const char *name;
+  PatternTask (*make)();
+};
+
+const TaskFrame TASK_FRAMES[] = {
+  { "scrollOnce",    [] { return scrollOnce(""); } },
+  { "scrollForever", [] { return scrollForever(""); } },
+  { "blinkError",    blinkError },
+  { "farewell",      farewell },
+  { "playSprite",    [] { return playSprite(AssetRef()); } },
+  { "runSelfTests",  [] { return runSelfTests(0); } },
+  { "testLEDS",      testAllSingleLEDs },
+  { "testALLON",     testAllLEDsOn },
+  { "testROWS",      testRows },
+  { "testCOLUMNS",   testColumns },
+  { "testMODULES",   testModules },
+  { "testCHECKER",   testCheckerboard },
+  { "testCORNERS",   testCorners },
+};
+constexpr uint8_t TASK_FRAME_COUNT = sizeof(TASK_FRAMES) / sizeof(TASK_FRAMES[0]);
+
+const char *taskFrameName(uint8_t i) {
+  return i < TASK_FRAME_COUNT ? TASK_FRAMES[i].name : nullptr;
+}
+
+// Frame size of TASK_FRAMES[i] in bytes
+size_t taskFrameSize(uint8_t i) {
+  uint32_t failures = taskArena.failures;
+  TASK_FRAMES[i].make();
+  taskArena.failures = failures;
+  return taskArena.lastFrame;
+}
+
+// Logs every coroutine whose frame does not fit a slot; false if any
+bool checkTaskFrames() {
+  bool ok = true;
+  for (uint8_t i = 0; i < TASK_FRAME_COUNT; i++) {
+    size_t size = taskFrameSize(i);
+    if (size <= TASK_FRAME_SIZE) continue;
+    ok = false;
+    if (beginLog()) {
+      Serial.print("Pattern task ");
+      Serial.print(TASK_FRAMES[i].name);
+      Serial.print(" needs a ");
+      Serial.print((unsigned)size);
+      Serial.print(" B frame, slots are ");
+      Serial.print((unsigned)TASK_FRAME_SIZE);
+      Serial.println(" B; raise TASK_FRAME_SIZE");
+    }
+  }
+  return ok;
+}
+
+// Logs frames the arena could not provide: at most one line a second while
+// it keeps failing
+void reportTaskFailures(unsigned long now) {
+  static uint32_t reported = 0;
+  static unsigned long lastReport = 0;
+  if (taskArena.failures == reported) return;
+  if (reported && now - lastReport < 1000) return;
+  if (beginLog()) {
+    Serial.print("Pattern task got no frame (");
+    Serial.print(taskArena.failures - reported);
+    Serial.print(" times, ");
+    Serial.print((unsigned)taskArena.failedFrame);
+    Serial.print(" B, ");
+    Serial.print(taskArena.inUse());
+    Serial.print('/');
+    Serial.print(TASK_FRAME_SLOTS);
+    Serial.println(" slots in use)");
+  }
+  reported = taskArena.failures;
+  lastReport = now;
+}
+
+// Starts a root task, logging when it can't (no frame or no free fiber)
+void spawnPattern(PatternTask &&task) {
+  if (patternScheduler.spawn(std::move(task))) return;
+  if (beginLog()) Serial.println("Pattern task could not start");
+}
+
+// Sprite asset `name`, or an empty ref if missing or truncated
+AssetRef findSprite(const char *name) {
+  AssetRef ref = assetFind(name, ASSET_SPRITE);
+  const AssetSprite *sp = (const AssetSprite *)ref.data;
+  if (!ref || ref.length < sizeof(AssetSprite) || sp->frameCount == 0 ||
+      ref.length < sizeof(AssetSprite) + (uint32_t)sp->frameCount * sp->width) {
+    return AssetRef();
+  }
+  return ref;
+}
+
 // --- PATTERN START ---------------------------------------------------------
+const char *patternName(Pattern p) {
+  switch (p) {
+    case PATTERN_SNAKE:    return "SNAKE";
+    case PATTERN_THINKING: return "THINKING";
+    case PATTERN_FINISH:   return "FINISH";
+    case PATTERN_REMOVE_FIGURE: return "REMOVE_FIGURE";
+    case PATTERN_ERROR:    return "ERROR";
+    case PATTERN_TEXT:     return "TEXT";
+    case PATTERN_FAREWELL: return "FAREWELL";
+    case PATTERN_SELFTEST: return "SELFTEST";
+    case PATTERN_SPRITE:   return "SPRITE";
+    case PATTERN_STRIP:    return "STRIP";
+    case PATTERN_PROGRESS: return "PROGRESS6";
+    default: return "NONE";
+  }
+}
+
+// Message of the looping scroll patterns
+const char *scrollerText(Pattern p) {
+  switch (p) {
+    case PATTERN_THINKING: return assetText("THINKING", "THINKING   ");
+    case PATTERN_FINISH:   return assetText("FINISH", "- THANK YOU FOR THE VISIT -   ");
+    default:               return assetText("REMOVE_FIGURE", "PLEASE REMOVE FIGURE   ");
+  }
+}
+
+void patternEvent(const char *name) {
+  beginEvent();
+  Serial.print("PATTERN ");
+  Serial.println(name);
+}
+
 void startPattern(Pattern p) {
   ps.current = p;
   ps.stage = 0;
   ps.var1 = 0;
   ps.var2 = 0;
   ps.lastStep = 0;
+  patternScheduler.cancelAll();
   clearAll();
+  patternEvent(patternName(p));
   
   switch (p) {
     case PATTERN_SNAKE:
-      Serial.println("Pattern=SNAKE");
       initSnake();
       break;
     case PATTERN_THINKING:
-      Serial.println("Pattern=THINKING");
-      ps.scrollX = DISPLAY_WIDTH; // Start off-screen right
-      break;
     case PATTERN_FINISH:
-      Serial.println("Pattern=FINISH");
-      ps.scrollX = DISPLAY_WIDTH; // Start off-screen right
-      break;
     case PATTERN_REMOVE_FIGURE:
-      Serial.println("Pattern=REMOVE_FIGURE");
-      ps.scrollX = DISPLAY_WIDTH; // Start off-screen right
+      spawnPattern(scrollForever(scrollerText(p)));
       break;
     case PATTERN_ERROR:
-      Serial.println("Pattern=ERROR");
-      ps.var1 = 0; // blink toggle
+      spawnPattern(blinkError());
+      break;
+    case PATTERN_FAREWELL:
+      spawnPattern(farewell());
+      break;
+    case PATTERN_SELFTEST: // test task is spawned by the SELFTEST command
+    case PATTERN_SPRITE:   // sprite task is spawned by the SPRITE command
       break;
     case PATTERN_TEXT:
-      Serial.println("Pattern=TEXT");
       if (ps.scrollDir == SCROLL_NONE) {
         // Centered static text - render immediately
-        drawCentered(ps.customText);
+        drawCentered(ps.customText.c_str(), *ps.font, ps.proportional);
       } else {
         // Scrolling text - start off-screen
-        ps.scrollX = (ps.scrollDir == SCROLL_LEFT) ? DISPLAY_WIDTH : -textWidth(ps.customText);
+        ps.scrollX = (ps.scrollDir == SCROLL_LEFT) ? DISPLAY_WIDTH : -ps.textPx;
+      }
+      break;
+    case PATTERN_STRIP:
+      if (ps.scrollDir == SCROLL_NONE) {
+        drawStrip((DISPLAY_WIDTH - ps.textPx) / 2);
+        flushFrame();
+      } else if (ps.scrollDir == SCROLL_LOOP) {
+        ps.scrollX = 0;
+      } else {
+        ps.scrollX = (ps.scrollDir == SCROLL_LEFT) ? DISPLAY_WIDTH : -ps.textPx;
       }
       break;
+    case PATTERN_PROGRESS:
+      initProgress();
+      break;
     default:
-      Serial.println("Pattern=NONE");
       break;
   }
 }
@@ -313,68 +614,7 @@ void updateSnake(unsigned long now) {
   for (int i = 0; i < 5; i++) {
     mx.setPoint(7 - ps.snake.body[i].y, ps.snake.body[i].x, true);
   }
-  mx.update();
-}
-
-void updateThinking(unsigned long now) {
-  int interval = adjustedInterval(80);
-  if (now - ps.lastStep < (unsigned long)interval) return;
-  ps.lastStep = now;
-  
-  String text = "THINKING   ";
-  mx.clear();
-  drawText(ps.scrollX, 0, text);
-  mx.update();
-  
-  ps.scrollX--;
-  if (ps.scrollX < -textWidth(text)) {
-    ps.scrollX = DISPLAY_WIDTH;
-  }
-}
-
-void updateFinish(unsigned long now) {
-  int interval = adjustedInterval(80);
-  if (now - ps.lastStep < (unsigned long)interval) return;
-  ps.lastStep = now;
-  
-  String text = "- THANK YOU FOR THE VISIT -   ";
-  mx.clear();
-  drawText(ps.scrollX, 0, text);
-  mx.update();
-  
-  ps.scrollX--;
-  if (ps.scrollX < -textWidth(text)) {
-    ps.scrollX = DISPLAY_WIDTH;
-  }
-}
-
-void updateRemoveFigure(unsigned long now) {
-  int interval = adjustedInterval(80);
-  if (now - ps.lastStep < (unsigned long)interval) return;
-  ps.lastStep = now;
-  
-  String text = "PLEASE REMOVE FIGURE   ";
-  mx.clear();
-  drawText(ps.scrollX, 0, text);
-  mx.update();
-  
-  ps.scrollX--;
-  if (ps.scrollX < -textWidth(text)) {
-    ps.scrollX = DISPLAY_WIDTH;
-  }
-}
-
-void updateError(unsigned long now) {
-  int interval = adjustedInterval(200);
-  if (now - ps.lastStep < (unsigned long)interval) return;
-  ps.lastStep = now;
-  ps.var1 = !ps.var1; // blink
-
-  mx.clear();
-  if (ps.var1) {
-    drawCentered("ERROR");
-  }
-  mx.update();
+  flushFrame();
 }
 
 void updateText(unsigned long now) {
@@ -388,36 +628,460 @@ void updateText(unsigned long now) {
   ps.lastStep = now;
   
   mx.clear();
-  drawText(ps.scrollX, 0, ps.customText);
-  mx.update();
+  if (ps.current == PATTERN_STRIP) drawStrip(ps.scrollX);
+  else drawText(ps.scrollX, 0, ps.customText.c_str(), *ps.font, ps.proportional);
+  flushFrame();
   
-  if (ps.scrollDir == SCROLL_LEFT) {
+  if (ps.scrollDir == SCROLL_LOOP) {
+    if (++ps.scrollX >= ps.textPx) ps.scrollX = 0;
+  } else if (ps.scrollDir == SCROLL_LEFT) {
     ps.scrollX--;
-    if (ps.scrollX < -textWidth(ps.customText)) {
+    if (ps.scrollX < -ps.textPx) {
       ps.scrollX = DISPLAY_WIDTH;
     }
   } else if (ps.scrollDir == SCROLL_RIGHT) {
     ps.scrollX++;
     if (ps.scrollX > DISPLAY_WIDTH) {
-      ps.scrollX = -textWidth(ps.customText);
+      ps.scrollX = -ps.textPx;
     }
   }
 }
 
+void updateProgress(unsigned long now) {
+  ProgressState &p = ps.progress;
+  for (uint8_t i = 0; i < TOKEN_COUNT; i++) {
+    if (!p.on[i] || p.stage[i] == SEGMENT_FULL || (long)(now - p.nextStep[i]) < 0) continue;
+    p.stage[i]++;
+    p.nextStep[i] = now + SEGMENT_STEP_MS;
+    drawSegment(i);
+  }
+}
+
 void updatePattern() {
   unsigned long now = millis();
   switch (ps.current) {
     case PATTERN_SNAKE:    updateSnake(now); break;
-    case PATTERN_THINKING: updateThinking(now); break;
-    case PATTERN_FINISH:   updateFinish(now); break;
-    case PATTERN_REMOVE_FIGURE: updateRemoveFigure(now); break;
-    case PATTERN_ERROR:    updateError(now); break;
     case PATTERN_TEXT:     updateText(now); break;
+    case PATTERN_STRIP:    updateText(now); break;
+    case PATTERN_PROGRESS: updateProgress(now); break;
     default: break;
   }
+  patternScheduler.tick(now);
+  reportTaskFailures(now);
 }
 
 // --- SERIAL COMMANDS -------------------------------------------------------
+int hexNibble(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+void logAssets() {
+  if (!beginLog()) return;
+  Serial.print("Assets: slot ");
+  Serial.print(assetsSlot());
+  Serial.print(", ");
+  Serial.print(assetsHeader()->count);
+  Serial.println(" entries");
+}
+
+// Decodes upload chunks into out[MAX_LINE / 2]; false on anything but hex pairs
+bool hexBytes(const char *hex, uint8_t *out, uint32_t &len) {
+  len = 0;
+  for (; hex[0] && hex[1] && len < MAX_LINE / 2; hex += 2) {
+    int hi = hexNibble(hex[0]), lo = hexNibble(hex[1]);
+    if (hi < 0 || lo < 0) break;
+    out[len++] = (hi << 4) | lo;
+  }
+  return *hex == 0;
+}
+
+// ASSET BEGIN <size> <crc32 hex> | DATA <offset> <hex bytes> | COMMIT | ABORT | STATUS
+void handleAssetCommand(String arg) {
+  arg.trim();
+  const char *err = nullptr;
+
+  if (arg.startsWith("BEGIN ")) {
+    int sp = arg.indexOf(' ', 6);
+    if (sp < 0) {
+      Serial.println("ERR ASSET BEGIN <size> <crc32>");
+      return;
+    }
+    uint32_t size = arg.substring(6, sp).toInt();
+    uint32_t crc = strtoul(arg.substring(sp + 1).c_str(), nullptr, 16);
+    err = assetUploadBegin(size, crc);
+  } else if (arg.startsWith("DATA ")) {
+    int sp = arg.indexOf(' ', 5);
+    if (sp < 0) {
+      Serial.println("ERR ASSET DATA <offset> <hex>");
+      return;
+    }
+    uint32_t offset = arg.substring(5, sp).toInt();
+    uint8_t chunk[MAX_LINE / 2];
+    uint32_t len = 0;
+    err = hexBytes(arg.c_str() + sp + 1, chunk, len) ? assetUploadData(offset, chunk, len) : "HEX";
+  } else if (arg == "COMMIT") {
+    // The current pattern may be reading from the slot that is about to be
+    // unmapped; it is stopped only once the new bundle has been verified
+    err = assetUploadCommit([] { startPattern(PATTERN_NONE); });
+  } else if (arg == "ABORT") {
+    assetUploadAbort();
+  } else if (arg == "STATUS") {
+    if (!assetsMounted()) {
+      Serial.println("OK ASSETS NONE");
+      return;
+    }
+    const AssetHeader *h = assetsHeader();
+    Serial.print("OK ASSETS SLOT="); Serial.print(assetsSlot());
+    Serial.print(" SEQ="); Serial.print((unsigned long)h->sequence);
+    Serial.print(" COUNT="); Serial.print(h->count);
+    Serial.print(" SIZE="); Serial.println((unsigned long)h->size);
+    return;
+  } else {
+    Serial.println("ERR UNKNOWN ASSET COMMAND");
+    return;
+  }
+
+  if (err) {
+    Serial.print("ERR ASSET ");
+    Serial.println(err);
+    return;
+  }
+  if (arg == "COMMIT") {
+    for (TextFit &c : fitCache) c.key = 0; // widths depend on the fonts just swapped in
+    logAssets();
+  }
+  Serial.println("OK");
+}
+
+// STRIP BEGIN <width> <crc32 hex> | DATA <offset> <hex bytes> | SHOW [CENTER|LEFT|RIGHT|LOOP]
+void handleStripCommand(String arg) {
+  arg.trim();
+  const char *err = nullptr;
+
+  if (arg.startsWith("BEGIN ")) {
+    int sp = arg.indexOf(' ', 6);
+    if (sp < 0) {
+      Serial.println("ERR STRIP BEGIN <width> <crc32>");
+      return;
+    }
+    // The pool is about to be overwritten
+    if (ps.current == PATTERN_STRIP) startPattern(PATTERN_NONE);
+    err = stripBegin(arg.substring(6, sp).toInt(), strtoul(arg.substring(sp + 1).c_str(), nullptr, 16));
+  } else if (arg.startsWith("DATA ")) {
+    int sp = arg.indexOf(' ', 5);
+    if (sp < 0) {
+      Serial.println("ERR STRIP DATA <offset> <hex>");
+      return;
+    }
+    uint32_t offset = arg.substring(5, sp).toInt();
+    uint8_t chunk[MAX_LINE / 2];
+    uint32_t len = 0;
+    err = hexBytes(arg.c_str() + sp + 1, chunk, len) ? stripData(offset, chunk, len) : "HEX";
+  } else if (arg == "SHOW" || arg.startsWith("SHOW ")) {
+    String mode = arg.substring(4);
+    mode.trim();
+    ScrollDirection dir;
+    if (mode == "")            dir = stripWidth() <= DISPLAY_WIDTH ? SCROLL_NONE : SCROLL_LEFT;
+    else if (mode == "CENTER") dir = SCROLL_NONE;
+    else if (mode == "LEFT")   dir = SCROLL_LEFT;
+    else if (mode == "RIGHT")  dir = SCROLL_RIGHT;
+    else if (mode == "LOOP")   dir = SCROLL_LOOP;
+    else {
+      Serial.println("ERR STRIP SHOW [CENTER|LEFT|RIGHT|LOOP]");
+      return;
+    }
+    if (!stripReady()) {
+      err = "EMPTY";
+    } else {
+      ps.scrollDir = dir;
+      ps.textPx = stripWidth();
+      startPattern(PATTERN_STRIP);
+    }
+  } else {
+    Serial.println("ERR UNKNOWN STRIP COMMAND");
+    return;
+  }
+
+  if (err) {
+    Serial.print("ERR STRIP ");
+    Serial.println(err);
+    return;
+  }
+  Serial.println("OK");
+}
+
+// OVERLAY <1-3> <ms> [BOX|OR|XOR|ERASE] <text> | OVERLAY <1-3|ALL> OFF
+void handleOverlayCommand(String arg) {
+  arg.trim();
+  int sp = arg.indexOf(' ');
+  String layer = arg.substring(0, sp < 0 ? arg.length() : sp);
+  String rest = sp < 0 ? String("") : arg.substring(sp + 1);
+  rest.trim();
+  uint8_t z = (layer == "ALL") ? 0 : layer.toInt();
+  if (rest == "OFF" && (layer == "ALL" || (z >= 1 && z <= OVERLAY_LAYERS))) {
+    overlayHide(z);
+    Serial.println("OK");
+    return;
+  }
+  sp = rest.indexOf(' ');
+  if (z < 1 || z > OVERLAY_LAYERS || sp < 0) {
+    Serial.println("ERR OVERLAY <1-3> <ms> [BOX|OR|XOR|ERASE] <text>");
+    return;
+  }
+  unsigned long ms = rest.substring(0, sp).toInt();
+  String text = rest.substring(sp + 1);
+  text.trim();
+
+  static const char *const BLENDS[] = { "BOX", "OR", "XOR", "ERASE" };
+  Blend blend = BLEND_BOX;
+  sp = text.indexOf(' ');
+  String word = text.substring(0, sp < 0 ? text.length() : sp);
+  for (uint8_t b = 0; b < 4; b++) {
+    if (word == BLENDS[b]) {
+      blend = (Blend)b;
+      text = sp < 0 ? String("") : text.substring(sp + 1);
+      text.trim();
+      break;
+    }
+  }
+
+  // Centered in the largest font that fits, like TEXT FIT, but never scrolled
+  TextFit fit = fitText(text.c_str());
+  int x = (DISPLAY_WIDTH - (fit.width - 1)) / 2;
+  overlayBegin();
+  mx.clear();
+  drawText(x < 0 ? 0 : x, 0, text.c_str(), assetFontOr(fit.font), true);
+  overlayEnd(z, blend, ms);
+  Serial.println("OK");
+}
+
+// --- STATE SNAPSHOT --------------------------------------------------------
+// STATE DUMP replies "OK STATE <hex>" with everything needed to put the
+// display back as it is; STATE LOAD <hex> checks the whole snapshot and then
+// applies it in one step, drawing the saved frame instead of clearing first,
+// so a reconnecting host can verify or take over without a visible restart.
+// Layout, little-endian:
+//
+//   u8  version, pattern, scrollDir, brightness, speed, font, flags, stage
+//   i16 scrollX, var1, var2, textPx
+//   u16 ms since the pattern's last step (capped)
+//   i8  snake body[5] x/y, food x/y, dirX, dirY
+//   u8  progress[6]        segment stage, 0x80 = token on
+//   u16 strip width, u32 strip CRC-32 (a STRIP snapshot only loads over the
+//       same strip, which stays in RAM)
+//   u8  frame[32]          columns, LSB = top row, without overlays
+//   u8  text length, text  TEXT message, or the sprite name for SPRITE
+//   u32 CRC-32 of all of the above
+//
+// Looping scrollers resume at their scroll position; ERROR, FAREWELL and
+// SPRITE restart their animation and a SELFTEST comes back as a still frame.
+// Overlays are transient and not included.
+constexpr uint8_t STATE_VERSION = 1;
+constexpr uint8_t STATE_FIXED = 8 + 8 + 2 + 14 + TOKEN_COUNT + 6 + DISPLAY_WIDTH + 1;
+constexpr uint8_t STATE_MAX_TEXT = 64;   // TEXT limit
+static_assert(STATE_FIXED + STATE_MAX_TEXT + 4 <= MAX_LINE / 2, "STATE LOAD must fit a line");
+
+struct StateWriter {
+  uint8_t *p;
+  void u8(uint8_t v) { *p++ = v; }
+  void u16(uint16_t v) { u8(v); u8(v >> 8); }
+  void u32(uint32_t v) { u16(v); u16(v >> 16); }
+};
+
+struct StateReader {
+  const uint8_t *p;
+  uint8_t u8() { return *p++; }
+  uint16_t u16() { uint16_t v = u8(); return v | u8() << 8; }
+  uint32_t u32() { uint32_t v = u16(); return v | (uint32_t)u16() << 16; }
+};
+
+uint8_t fontIndex(const BitmapFont *f) {
+  for (uint8_t i = 0; i < FONT_COUNT; i++) {
+    if (&assetFontOr(i) == f) return i;
+  }
+  return 0;
+}
+
+uint32_t stripCrc() { return crc32Update(0, stripColumns(), stripWidth()); }
+
+uint8_t encodeState(uint8_t *out) {
+  StateWriter w{out};
+  unsigned long idle = millis() - ps.lastStep;
+  w.u8(STATE_VERSION);
+  w.u8(ps.current);
+  w.u8(ps.scrollDir);
+  w.u8(gBrightness);
+  w.u8(gSpeed);
+  w.u8(fontIndex(ps.font));
+  w.u8(ps.proportional ? 1 : 0);
+  w.u8(ps.stage);
+  w.u16(ps.scrollX);
+  w.u16(ps.var1);
+  w.u16(ps.var2);
+  w.u16(ps.textPx);
+  w.u16(idle > 0xFFFF ? 0xFFFF : idle);
+  for (const Point &b : ps.snake.body) { w.u8(b.x); w.u8(b.y); }
+  w.u8(ps.snake.food.x);
+  w.u8(ps.snake.food.y);
+  w.u8(ps.snake.dirX);
+  w.u8(ps.snake.dirY);
+  for (uint8_t i = 0; i < TOKEN_COUNT; i++) {
+    w.u8(ps.progress.stage[i] | (ps.progress.on[i] ? 0x80 : 0));
+  }
+  w.u16(stripReady() ? stripWidth() : 0);
+  w.u32(stripReady() ? stripCrc() : 0);
+  for (uint8_t c = 0; c < DISPLAY_WIDTH; c++) w.u8(reverseBits(mx.getColumn(c)));
+  uint8_t len = ps.customText.length() < STATE_MAX_TEXT ? ps.customText.length() : STATE_MAX_TEXT;
+  w.u8(len);
+  memcpy(w.p, ps.customText.c_str(), len);
+  w.p += len;
+  w.u32(crc32Update(0, out, w.p - out));
+  return w.p - out;
+}
+
+bool inPanel(int8_t x, int8_t y) { return x >= 0 && x < DISPLAY_WIDTH && y >= 0 && y < 8; }
+
+// scrollX and textPx as the pattern itself keeps them: textPx is the width it
+// measures (drawStrip indexes the strip with scrollX, LOOP wraps at textPx)
+bool scrollInRange(const PatternState &s) {
+  int w;
+  switch (s.current) {
+    case PATTERN_STRIP: w = stripWidth(); break;
+    case PATTERN_TEXT:  w = textWidth(s.customText.c_str(), *s.font, s.proportional); break;
+    case PATTERN_THINKING:
+    case PATTERN_FINISH:
+    case PATTERN_REMOVE_FIGURE:
+      return s.scrollX >= -textWidth(scrollerText(s.current)) && s.scrollX <= DISPLAY_WIDTH;
+    default: return true;
+  }
+  if (s.textPx != w) return false;
+  if (s.scrollDir == SCROLL_NONE) return true;            // scrollX unused
+  if (s.scrollDir == SCROLL_LOOP) return s.scrollX >= 0 && s.scrollX < w;
+  return s.scrollX >= -w && s.scrollX <= DISPLAY_WIDTH;
+}
+
+// Checks everything before touching the display; nullptr or the ERR reason
+const char *loadState(const uint8_t *in, uint32_t len) {
+  if (len < STATE_FIXED + 4u) return "SIZE";
+  if (crc32Update(0, in, len - 4) != StateReader{in + len - 4}.u32()) return "CRC";
+  StateReader r{in};
+  if (r.u8() != STATE_VERSION) return "VERSION";
+
+  PatternState next = ps;
+  uint8_t pattern = r.u8(), dir = r.u8(), bright = r.u8(), speed = r.u8(), font = r.u8();
+  if (pattern > PATTERN_PROGRESS || dir > SCROLL_LOOP || bright > 15 || speed > 10 || font >= FONT_COUNT) {
+    return "RANGE";
+  }
+  next.current = (Pattern)pattern;
+  next.scrollDir = (ScrollDirection)dir;
+  next.font = &assetFontOr(font);
+  next.proportional = r.u8() & 1;
+  next.stage = r.u8();
+  next.scrollX = r.u16();
+  next.var1 = r.u16();
+  next.var2 = r.u16();
+  next.textPx = r.u16();
+  uint16_t idle = r.u16();
+  for (Point &b : next.snake.body) { b.x = r.u8(); b.y = r.u8(); }
+  next.snake.food.x = r.u8();
+  next.snake.food.y = r.u8();
+  next.snake.dirX = r.u8();
+  next.snake.dirY = r.u8();
+  for (const Point &b : next.snake.body) {
+    if (!inPanel(b.x, b.y)) return "RANGE";
+  }
+  if (!inPanel(next.snake.food.x, next.snake.food.y)) return "RANGE";
+  for (uint8_t i = 0; i < TOKEN_COUNT; i++) {
+    uint8_t v = r.u8();
+    next.progress.stage[i] = v & 0x7F;
+    next.progress.on[i] = v & 0x80;
+    if (next.progress.stage[i] > SEGMENT_FULL) return "RANGE";
+  }
+  uint16_t stripW = r.u16();
+  uint32_t stripC = r.u32();
+  if (next.current == PATTERN_STRIP && (!stripReady() || stripWidth() != stripW || stripCrc() != stripC)) {
+    return "STRIP";
+  }
+  const uint8_t *frame = r.p;
+  r.p += DISPLAY_WIDTH;
+  uint8_t textLen = r.u8();
+  if (textLen > STATE_MAX_TEXT || STATE_FIXED + textLen + 4u != len) return "SIZE";
+  char text[STATE_MAX_TEXT + 1];
+  memcpy(text, r.p, textLen);
+  text[textLen] = 0;
+  next.customText = text;
+  if (!scrollInRange(next)) return "RANGE";
+  AssetRef sprite;
+  if (next.current == PATTERN_SPRITE && !(sprite = findSprite(next.customText.c_str()))) return "SPRITE";
+  if (next.current == PATTERN_SELFTEST) next.current = PATTERN_NONE;
+
+  // Apply
+  patternScheduler.cancelAll();
+  ps = next;
+  unsigned long now = millis();
+  ps.lastStep = now - idle;
+  for (unsigned long &t : ps.progress.nextStep) t = now + SEGMENT_STEP_MS;
+  gSpeed = speed;
+  gBrightness = bright;
+  mx.control(MD_MAX72XX::INTENSITY, gBrightness);
+  for (uint8_t c = 0; c < DISPLAY_WIDTH; c++) mx.setColumn(c, reverseBits(frame[c]));
+  flushFrame();
+
+  switch (ps.current) {
+    case PATTERN_THINKING:
+    case PATTERN_FINISH:
+    case PATTERN_REMOVE_FIGURE:
+      spawnPattern(scrollForever(scrollerText(ps.current), ps.scrollX));
+      break;
+    case PATTERN_ERROR:    spawnPattern(blinkError()); break;
+    case PATTERN_FAREWELL: spawnPattern(farewell()); break;
+    case PATTERN_SPRITE:   spawnPattern(playSprite(sprite)); break;
+    default: break;
+  }
+  patternEvent(patternName(ps.current));
+  return nullptr;
+}
+
+// STATE DUMP | STATE LOAD <hex>
+void handleStateCommand(String arg) {
+  arg.trim();
+  if (arg == "DUMP") {
+    static const char HEX_DIGITS[] = "0123456789ABCDEF";
+    uint8_t snap[MAX_LINE / 2];
+    char line[MAX_LINE + 1];
+    uint8_t n = encodeState(snap);
+    for (uint8_t i = 0; i < n; i++) {
+      line[2 * i] = HEX_DIGITS[snap[i] >> 4];
+      line[2 * i + 1] = HEX_DIGITS[snap[i] & 0x0F];
+    }
+    line[2 * n] = 0;
+    Serial.print("OK STATE ");
+    Serial.println(line);
+    return;
+  }
+  if (arg.startsWith("LOAD ")) {
+    String hex = arg.substring(5);
+    hex.trim();
+    uint8_t snap[MAX_LINE / 2];
+    uint32_t len = 0;
+    if (!hexBytes(hex.c_str(), snap, len)) {
+      Serial.println("ERR STATE HEX");
+      return;
+    }
+    const char *err = loadState(snap, len);
+    if (err) {
+      Serial.print("ERR STATE ");
+      Serial.println(err);
+      return;
+    }
+    Serial.println("OK");
+    return;
+  }
+  Serial.println("ERR STATE <DUMP|LOAD <hex>>");
+}
+
 void handleCommand(const String &line) {
   String cmd = line;
   cmd.trim();
@@ -433,6 +1097,8 @@ void handleCommand(const String &line) {
     else if (arg == "REMOVE_FIGURE") startPattern(PATTERN_REMOVE_FIGURE);
     else if (arg == "PRINTING") startPattern(PATTERN_THINKING); // Reuse thinking for printing
     else if (arg == "ERROR")    startPattern(PATTERN_ERROR);
+    else if (arg == "FAREWELL") startPattern(PATTERN_FAREWELL);
+    else if (arg == "PROGRESS6") startPattern(PATTERN_PROGRESS);
     else {
       Serial.println("ERR UNKNOWN PATTERN");
       return;
@@ -458,7 +1124,7 @@ void handleCommand(const String &line) {
     if (lastSpace > 0) {
       String lastWord = arg.substring(lastSpace + 1);
       lastWord.trim();
-      if (lastWord == "LEFT" || lastWord == "RIGHT" || lastWord == "CENTER") {
+      if (lastWord == "LEFT" || lastWord == "RIGHT" || lastWord == "CENTER" || lastWord == "FIT") {
         direction = lastWord;
         text = arg.substring(0, lastSpace);
         text.trim();
@@ -467,18 +1133,143 @@ void handleCommand(const String &line) {
     
     // Set text and direction
     ps.customText = text;
+    ps.font = &assetFontOr(0);
+    ps.proportional = false;
     if (direction == "LEFT") {
       ps.scrollDir = SCROLL_LEFT;
     } else if (direction == "RIGHT") {
       ps.scrollDir = SCROLL_RIGHT;
+    } else if (direction == "FIT") {
+      // Static in the largest font that fits, scroll only if none does
+      TextFit fit = fitText(text.c_str());
+      ps.font = &assetFontOr(fit.font);
+      ps.proportional = true;
+      ps.scrollDir = fit.fits ? SCROLL_NONE : SCROLL_LEFT;
     } else {
       ps.scrollDir = SCROLL_NONE; // Default to centered
     }
+    ps.textPx = (direction == "FIT") ? fitText(text.c_str()).width
+                                     : textWidth(ps.customText.c_str(), *ps.font, ps.proportional);
     
     startPattern(PATTERN_TEXT);
     Serial.println("OK");
     return;
   }
+  if (cmd.startsWith("SELFTEST ")) {
+    String arg = cmd.substring(9);
+    arg.trim();
+    bool fast = false;
+    if (arg.endsWith(" FAST")) {
+      fast = true;
+      arg = arg.substring(0, arg.length() - 5);
+      arg.trim();
+    }
+
+    uint8_t index = SELF_TEST_COUNT; // ALL
+    if (arg != "ALL") {
+      for (index = 0; index < SELF_TEST_COUNT; index++) {
+        if (arg == SELF_TESTS[index].name) break;
+      }
+      if (index == SELF_TEST_COUNT) {
+        Serial.println("ERR UNKNOWN SELFTEST");
+        return;
+      }
+    }
+
+    selfTestDivider = fast ? SELFTEST_FAST_DIVIDER : 1;
+    startPattern(PATTERN_SELFTEST);
+    spawnPattern(runSelfTests(index));
+    Serial.println("OK");
+    return;
+  }
+  if (cmd.startsWith("SPRITE ")) {
+    String name = cmd.substring(7);
+    name.trim();
+    AssetRef ref = findSprite(name.c_str());
+    if (!ref) {
+      Serial.println("ERR UNKNOWN SPRITE");
+      return;
+    }
+    ps.customText = name;
+    startPattern(PATTERN_SPRITE);
+    spawnPattern(playSprite(ref));
+    Serial.println("OK");
+    return;
+  }
+  if (cmd.startsWith("ASSET ")) {
+    handleAssetCommand(cmd.substring(6));
+    return;
+  }
+  if (cmd == "TOKEN STATS") {
+    const TokenLatency &t = tokenLatency;
+    Serial.print("OK TOKEN N="); Serial.print((unsigned long)t.count);
+    Serial.print(" LAST_US="); Serial.print((unsigned long)t.lastUs);
+    Serial.print(" MAX_US="); Serial.print((unsigned long)t.maxUs);
+    Serial.print(" AVG_US="); Serial.println((unsigned long)(t.count ? t.totalUs / t.count : 0));
+    return;
+  }
+  if (cmd.startsWith("TOKEN ")) {
+    // TOKEN <1-6> ON|OFF
+    String arg = cmd.substring(6);
+    arg.trim();
+    int sp = arg.indexOf(' ');
+    String num = arg.substring(0, sp < 0 ? arg.length() : sp);
+    String state = sp < 0 ? String("") : arg.substring(sp + 1);
+    state.trim();
+    int n = num.length() == 1 ? num.toInt() : 0;
+    if (n < 1 || n > TOKEN_COUNT || (state != "ON" && state != "OFF")) {
+      Serial.println("ERR TOKEN <1-6> ON|OFF");
+      return;
+    }
+    if (ps.current != PATTERN_PROGRESS) startPattern(PATTERN_PROGRESS);
+    setToken(n - 1, state == "ON");
+
+    uint32_t us = micros() - lineStartUs;
+    TokenLatency &t = tokenLatency;
+    t.count++;
+    t.lastUs = us;
+    if (us > t.maxUs) t.maxUs = us;
+    t.totalUs += us;
+    if (beginLog()) {
+      Serial.print("TOKEN "); Serial.print(n); Serial.print(' '); Serial.print(state);
+      Serial.print(' '); Serial.print((unsigned long)us); Serial.println("us");
+    }
+    Serial.println("OK");
+    return;
+  }
+  if (cmd.startsWith("OVERLAY ")) {
+    handleOverlayCommand(cmd.substring(8));
+    return;
+  }
+  if (cmd.startsWith("STATE ")) {
+    handleStateCommand(cmd.substring(6));
+    return;
+  }
+  if (cmd.startsWith("STRIP ")) {
+    handleStripCommand(cmd.substring(6));
+    return;
+  }
+  if (cmd.startsWith("MIRROR ")) {
+    String arg = cmd.substring(7);
+    arg.trim();
+    if (arg == "OFF") {
+      mirrorStop();
+      Serial.println("OK MIRROR=OFF");
+      return;
+    }
+    if (arg != "ON" && !arg.startsWith("ON ")) {
+      Serial.println("ERR MIRROR <ON [hz]|OFF>");
+      return;
+    }
+    mirrorStart(arg.length() > 3 ? arg.substring(3).toInt() : MIRROR_DEFAULT_HZ);
+    Serial.print("OK MIRROR="); Serial.println(mirrorHz());
+    return;
+  }
+  if (cmd == "LOG ON" || cmd == "LOG OFF") {
+    logOn = (cmd == "LOG ON");
+    Serial.println(logOn ? "OK LOG=ON" : "OK LOG=OFF");
+    return;
+  }
   if (cmd == "STOP") {
     startPattern(PATTERN_NONE);
     Serial.println("OK");
@@ -510,22 +1301,14 @@ void handleCommand(const String &line) {
 
   if (cmd == "STATUS") {
     Serial.print("OK PATTERN=");
-    switch (ps.current) {
-      case PATTERN_SNAKE:    Serial.print("SNAKE"); break;
-      case PATTERN_THINKING: Serial.print("THINKING"); break;
-      case PATTERN_FINISH:   Serial.print("FINISH"); break;
-      case PATTERN_REMOVE_FIGURE: Serial.print("REMOVE_FIGURE"); break;
-      case PATTERN_ERROR:    Serial.print("ERROR"); break;
-      case PATTERN_TEXT:     Serial.print("TEXT"); break;
-      default: Serial.print("NONE"); break;
-    }
+    Serial.print(patternName(ps.current));
     Serial.print(" SPEED="); Serial.print(gSpeed);
     Serial.print(" BRIGHT="); Serial.println(gBrightness);
     return;
   }
 
   if (cmd == "HELP") {
-    Serial.println("OK COMMANDS: PATTERN <SNAKE|THINKING|FINISH|REMOVE_FIGURE|ERROR>, TEXT <message> [LEFT|RIGHT|CENTER], STOP, CLEAR, SPEED <0-10>, BRIGHT <0-15>, STATUS, HELP");
+    Serial.println("OK COMMANDS: PATTERN <SNAKE|THINKING|FINISH|REMOVE_FIGURE|ERROR|FAREWELL|PROGRESS6>, TOKEN <1-6> <ON|OFF>, TEXT <message> [LEFT|RIGHT|CENTER|FIT], SELFTEST <LEDS|ALLON|ROWS|COLUMNS|MODULES|CHECKER|CORNERS|ALL> [FAST], SPRITE <name>, STRIP <BEGIN|DATA|SHOW>, OVERLAY <1-3> <ms> [BOX|OR|XOR|ERASE] <text>, ASSET <BEGIN|DATA|COMMIT|ABORT|STATUS>, MIRROR <ON [hz]|OFF>, STATE <DUMP|LOAD <hex>>, STOP, CLEAR, SPEED <0-10>, BRIGHT <0-15>, LOG <ON|OFF>, STATUS, HELP");
     return;
   }
 
@@ -542,8 +1325,9 @@ void readSerialCommands() {
         buf = "";
       }
     } else {
+      if (buf.length() == 0) lineStartUs = micros();
       buf += ch;
-      if (buf.length() > 64) buf.remove(0, 32); // prevent runaway
+      if (buf.length() > MAX_LINE) buf.remove(0, MAX_LINE / 2); // prevent runaway
     }
   }
 }
@@ -551,21 +1335,27 @@ void readSerialCommands() {
 // --- SETUP / LOOP ----------------------------------------------------------
 void setup() {
   Serial.begin(115200);
-  delay(500);
-  Serial.println("\n=== LED Controller Ready ===");
-  Serial.println("Commands: PATTERN <SNAKE|THINKING|FINISH|REMOVE_FIGURE|ERROR>, TEXT <message> [LEFT|RIGHT|CENTER], STOP, CLEAR, SPEED <0-10>, BRIGHT <0-15>, STATUS, HELP");
+  delay(BOOT_DELAY_MS);
+  Serial.println();
+  if (beginLog()) Serial.println("=== LED Controller Ready ===");
+  if (beginLog()) Serial.println("Commands: PATTERN <SNAKE|THINKING|FINISH|REMOVE_FIGURE|ERROR|FAREWELL|PROGRESS6>, TOKEN <1-6> <ON|OFF>, TEXT <message> [LEFT|RIGHT|CENTER|FIT], SELFTEST <LEDS|ALLON|ROWS|COLUMNS|MODULES|CHECKER|CORNERS|ALL> [FAST], SPRITE <name>, STRIP <BEGIN|DATA|SHOW>, OVERLAY <1-3> <ms> [BOX|OR|XOR|ERASE] <text>, ASSET <BEGIN|DATA|COMMIT|ABORT|STATUS>, MIRROR <ON [hz]|OFF>, STATE <DUMP|LOAD <hex>>, STOP, CLEAR, SPEED <0-10>, BRIGHT <0-15>, LOG <ON|OFF>, STATUS, HELP");
 
   if (!mx.begin()) {
-    Serial.println("Error initializing MD_MAX72XX library!");
+    if (beginLog()) Serial.println("Error initializing MD_MAX72XX library!");
     while (1) {}
   }
-  // Batch updates to reduce flicker; we call mx.update() manually
+  // Batch updates to reduce flicker; frames are sent by flushFrame()
   mx.control(MD_MAX72XX::UPDATE, MD_MAX72XX::OFF);
   mx.control(MD_MAX72XX::INTENSITY, gBrightness);
   clearAll();
+
+  if (assetsMount()) logAssets();
+  checkTaskFrames();
 }
 
 void loop() {
   readSerialCommands();
   updatePattern();
+  overlayTick(millis());
+  mirrorTick(millis());
 }
@@ -0,0 +1,129 @@
+#include "mirror.h"
+
+#include <Arduino.h>
+#include <MD_MAX72xx.h>
+#include <string.h>
+#include "channels.h"
+#include "overlay.h"
+
+extern MD_MAX72XX mx;
+
+struct Mirror {
+  bool enabled = false;
+  uint8_t hz = MIRROR_DEFAULT_HZ;
+  uint8_t seq = 0;
+  bool needKeyframe = true;
+  unsigned long lastFrame = 0;
+  unsigned long lastKeyframe = 0;
+  uint8_t sent[MIRROR_MAX_COLUMNS];   // what the host has, not what we drew
+};
+
+static Mirror mirror;
+
+void mirrorStart(uint8_t hz) {
+  if (hz == 0) hz = MIRROR_DEFAULT_HZ;
+  if (hz > MIRROR_MAX_HZ) hz = MIRROR_MAX_HZ;
+  mirror.enabled = true;
+  mirror.hz = hz;
+  mirror.needKeyframe = true;
+}
+
+void mirrorStop() { mirror.enabled = false; }
+bool mirrorEnabled() { return mirror.enabled; }
+uint8_t mirrorHz() { return mirror.hz; }
+
+// Library columns have the top row in bit 7; sprites and the wire use bit 0
+static uint8_t reverseBits(uint8_t b) {
+  b = (b & 0xF0) >> 4 | (b & 0x0F) << 4;
+  b = (b & 0xCC) >> 2 | (b & 0x33) << 2;
+  b = (b & 0xAA) >> 1 | (b & 0x55) << 1;
+  return b;
+}
+
+// Token stream for cur XOR ref, returns its length (see mirror.h)
+static uint8_t encodeDelta(const uint8_t *cur, const uint8_t *ref, uint8_t n, uint8_t *out) {
+  uint8_t len = 0;
+  uint8_t i = 0;
+  while (i < n) {
+    uint8_t run = 0;
+    while (i + run < n && run < 128 && cur[i + run] == ref[i + run]) run++;
+    if (i + run == n) break;            // trailing unchanged columns are implied
+    if (run) {
+      out[len++] = run - 1;
+      i += run;
+      continue;
+    }
+    uint8_t lit = 0;
+    while (i + lit < n && lit < 128 && cur[i + lit] != ref[i + lit]) lit++;
+    out[len++] = 0x7F + lit;
+    for (uint8_t k = 0; k < lit; k++, i++) out[len++] = cur[i] ^ ref[i];
+  }
+  return len;
+}
+
+static void predict(int8_t shift, uint8_t n, uint8_t *ref) {
+  for (uint8_t i = 0; i < n; i++) {
+    int src = i + shift;
+    ref[i] = (src >= 0 && src < n) ? mirror.sent[src] : 0;
+  }
+}
+
+void mirrorTick(unsigned long now) {
+  if (!mirror.enabled) return;
+  if (now - mirror.lastFrame < 1000UL / mirror.hz) return;
+  mirror.lastFrame = now;
+
+  uint8_t n = mx.getColumnCount() < MIRROR_MAX_COLUMNS ? mx.getColumnCount() : MIRROR_MAX_COLUMNS;
+  uint8_t cur[MIRROR_MAX_COLUMNS];
+  for (uint8_t c = 0; c < n; c++) cur[c] = reverseBits(frameColumn(c));  // overlays included
+
+  bool key = mirror.needKeyframe || now - mirror.lastKeyframe >= MIRROR_KEYFRAME_MS;
+  if (!key && memcmp(cur, mirror.sent, n) == 0) return;
+
+  uint8_t ref[MIRROR_MAX_COLUMNS];
+  uint8_t best[MIRROR_MAX_COLUMNS * 2 + 2], tmp[sizeof(best)];
+  uint8_t bestLen;
+  int8_t bestShift = 0;
+  if (key) {
+    memset(ref, 0, n);
+    bestLen = encodeDelta(cur, ref, n, best);
+  } else {
+    predict(0, n, ref);
+    bestLen = encodeDelta(cur, ref, n, best);
+    for (int8_t s = -MIRROR_MAX_SHIFT; s <= MIRROR_MAX_SHIFT && bestLen > 2; s++) {
+      if (s == 0) continue;
+      predict(s, n, ref);
+      uint8_t len = encodeDelta(cur, ref, n, tmp);
+      if (len < bestLen) {
+        bestLen = len;
+        bestShift = s;
+        memcpy(best, tmp, len);
+      }
+    }
+  }
+
+  // "!MF 255 -3 " + hex + "\n"
+  static const char HEX_DIGITS[] = "0123456789ABCDEF";
+  char line[16 + sizeof(best) * 2];
+  int pos = snprintf(line, 16, "%cMF %u ", EVENT_PREFIX, mirror.seq);
+  if (key) line[pos++] = 'K';
+  else pos += snprintf(line + pos, 4, "%d", bestShift);
+  line[pos++] = ' ';
+  for (uint8_t i = 0; i < bestLen; i++) {
+    line[pos++] = HEX_DIGITS[best[i] >> 4];
+    line[pos++] = HEX_DIGITS[best[i] & 0x0F];
+  }
+  line[pos++] = '\n';
+
+  // Drop the frame rather than block the render loop; the host keeps the
+  // previous frame and `sent` still matches it
+  if (Serial.availableForWrite() < pos) return;
+  Serial.write((const uint8_t *)line, pos);
+
+  memcpy(mirror.sent, cur, n);
+  mirror.seq++;
+  if (key) {
+    mirror.needKeyframe = false;
+    mirror.lastKeyframe = now;
+  }
+}
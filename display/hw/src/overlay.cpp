@@ -0,0 +1,112 @@
+#include "overlay.h"
+
+#include <Arduino.h>
+#include <MD_MAX72xx.h>
+
+extern MD_MAX72XX mx;
+
+static_assert(FRAME_COLUMNS % 4 == 0, "frames are packed four digit bytes per word");
+
+struct Layer {
+  uint32_t bits[FRAME_WORDS];
+  uint32_t mask[FRAME_WORDS];
+  Blend blend = BLEND_BOX;
+  bool active = false;
+  unsigned long until = 0;   // 0 = no timeout
+};
+
+static Layer layers[OVERLAY_LAYERS + 1];   // [0] unused, the base is mx's buffer
+static uint8_t activeCount = 0;
+static uint32_t shown[FRAME_WORDS];        // last composited frame
+static uint32_t saved[FRAME_WORDS];        // base while an overlay is drawn
+
+static void readFrame(uint32_t *words) { mx.getDigits((uint8_t *)words); }
+
+// Only the digits whose bits differ under mask are rewritten and marked for
+// the next update()
+static void writeFrame(const uint32_t *words, const uint32_t *mask) {
+  mx.setDigits((const uint8_t *)words, (const uint8_t *)mask);
+}
+
+void flushFrame() {
+  if (activeCount == 0) {
+    mx.update();
+    return;
+  }
+
+  uint32_t base[FRAME_WORDS], diff[FRAME_WORDS];
+  readFrame(base);
+  for (uint8_t w = 0; w < FRAME_WORDS; w++) {
+    uint32_t out = base[w];
+    for (uint8_t z = 1; z <= OVERLAY_LAYERS; z++) {
+      const Layer &l = layers[z];
+      if (!l.active) continue;
+      switch (l.blend) {
+        case BLEND_BOX:   out = (out & ~l.mask[w]) | l.bits[w]; break;
+        case BLEND_OR:    out |= l.bits[w]; break;
+        case BLEND_XOR:   out ^= l.bits[w]; break;
+        case BLEND_ERASE: out &= ~l.bits[w]; break;
+      }
+    }
+    shown[w] = out;
+    diff[w] = out ^ base[w];
+  }
+  // Only the pixels the overlays change go in and come back out, so update()
+  // sends the rows the pattern or an overlay changed and nothing else
+  writeFrame(shown, diff);
+  mx.update();
+  writeFrame(base, diff);
+}
+
+uint8_t frameColumn(uint8_t c) {
+  return activeCount ? mx.getDigitsColumn((const uint8_t *)shown, c) : mx.getColumn(c);
+}
+
+void overlayBegin() { readFrame(saved); }
+
+void overlayEnd(uint8_t z, Blend blend, unsigned long ms) {
+  if (z < 1 || z > OVERLAY_LAYERS) return;
+  Layer &l = layers[z];
+  readFrame(l.bits);
+
+  // Box around the drawn columns, one column of margin each side, drawn into
+  // mx to get it in the same digit layout
+  uint8_t cols[FRAME_COLUMNS] = {};
+  for (int c = 0; c < FRAME_COLUMNS; c++) {
+    if (!mx.getColumn(c)) continue;
+    for (int m = c - 1; m <= c + 1; m++) {
+      if (m >= 0 && m < FRAME_COLUMNS) cols[m] = 0xFF;
+    }
+  }
+  mx.blit(0, cols, FRAME_COLUMNS);
+  readFrame(l.mask);
+  writeFrame(saved, nullptr);
+
+  if (!l.active) activeCount++;
+  l.active = true;
+  l.blend = blend;
+  l.until = ms ? millis() + ms : 0;
+  flushFrame();
+}
+
+void overlayHide(uint8_t z) {
+  bool changed = false;
+  for (uint8_t i = 1; i <= OVERLAY_LAYERS; i++) {
+    if ((z == 0 || z == i) && layers[i].active) {
+      layers[i].active = false;
+      activeCount--;
+      changed = true;
+    }
+  }
+  if (changed) flushFrame();
+}
+
+bool overlayActive(uint8_t z) { return z >= 1 && z <= OVERLAY_LAYERS && layers[z].active; }
+uint8_t overlayCount() { return activeCount; }
+
+void overlayTick(unsigned long now) {
+  for (uint8_t z = 1; z <= OVERLAY_LAYERS; z++) {
+    const Layer &l = layers[z];
+    if (l.active && l.until && (long)(now - l.until) >= 0) overlayHide(z);
+  }
+}
@@ -0,0 +1,44 @@
+#include "strip.h"
+
+#include <string.h>
+#include "assets.h"
+
+struct Strip {
+  uint8_t columns[STRIP_MAX_COLUMNS];
+  uint16_t width = 0;
+  uint16_t received = 0;
+  uint32_t crc = 0;
+  bool ready = false;
+};
+
+static Strip strip;
+
+const char *stripBegin(uint32_t width, uint32_t crc) {
+  strip.ready = false;
+  strip.width = 0;
+  strip.received = 0;
+  if (width == 0 || width > STRIP_MAX_COLUMNS) return "SIZE";
+  strip.width = width;
+  strip.crc = crc;
+  return nullptr;
+}
+
+const char *stripData(uint32_t offset, const uint8_t *data, uint32_t len) {
+  if (strip.width == 0 || strip.ready) return "NOT STARTED";
+  if (offset != strip.received) return "OFFSET";
+  if (len > (uint32_t)(strip.width - strip.received)) return "SIZE";
+  memcpy(strip.columns + offset, data, len);
+  strip.received += len;
+  if (strip.received < strip.width) return nullptr;
+
+  if (crc32Update(0, strip.columns, strip.width) != strip.crc) {
+    strip.width = 0;
+    return "CRC";
+  }
+  strip.ready = true;
+  return nullptr;
+}
+
+bool stripReady() { return strip.ready; }
+uint16_t stripWidth() { return strip.ready ? strip.width : 0; }
+const uint8_t *stripColumns() { return strip.columns; }
@@ -0,0 +1,358 @@
+#!/usr/bin/env python3
+"""
+Visitor-cycle latency benchmark for the LED display.
+
+Runs the main loop of figurine_service.py itself against the host-native
+firmware, with a scripted RFID reader and stand-ins for content generation
+and printing, so the display choreography is always the service's current
+one (SNAKE, the six TOKEN segments, HI, THINKING, VOILA, THANK YOU!, REMOVE
+FIGURE, clear, and the STATE DUMP check between cycles). For every
+visitor-facing transition it measures the time from sending the command
+until the acknowledgement and until the panel first changes because of it.
+The stand-in waits (tag scan, content generation, printing, token removal)
+take one second each by default and are reported separately from the
+display's share.
+
+Build the firmware for the host first:
+    cd display/hw && pio run -e native
+
+Usage:
+    python scripts/display_latency_benchmark.py --runs 50 --virtual
+    python scripts/display_latency_benchmark.py --runs 5            # real time
+    python scripts/display_latency_benchmark.py --json results.json
+
+--virtual runs the firmware on a virtual clock: the waits cost nothing,
+commands take their transfer time at 115200 baud plus the firmware's 1 ms
+loop() ticks, and results are exactly repeatable. Real-time runs include
+serial, scheduling and loop() jitter and take ~15 s per cycle.
+
+A frame is attributed to a command only once the firmware has read it (the
+READ lines of the host build's event log), so frames still drawn by the
+previous pattern, e.g. the running SNAKE before TOKEN 1, are not counted.
+"""
+import argparse
+import contextlib
+import json
+import logging
+import os
+import subprocess
+import sys
+import tempfile
+import time
+import types
+from pathlib import Path
+from unittest import mock
+
+# Add src to path for imports
+sys.path.insert(0, str(Path(__file__).parent.parent / 'src'))
+
+from display_controller import DisplayController
+
+DEFAULT_BINARY = Path(__file__).parent.parent / 'display' / 'hw' / '.pio' / 'build' / 'native' / 'program'
+
+# Service dependencies that print, generate content or go online; the
+# benchmark replaces them, so they need not be installed
+STUBBED_MODULES = ('printer_controller', 'slip_data_generation', 'slip_printing',
+                   'supabase_upload', 'data_service', 'content_generation')
+
+
+class RealClock:
+    def __init__(self, proc):
+        self.proc = proc
+        self.waited = 0.0
+
+    def now_us(self):
+        return time.monotonic_ns() // 1000   # same clock as the firmware's event log
+
+    def wait(self, seconds):
+        self.waited += seconds
+        if seconds:
+            time.sleep(seconds)
+
+
+class VirtualClock:
+    """Advances the firmware's virtual clock; the benchmark never sleeps."""
+    def __init__(self, proc):
+        self.proc = proc
+        self.waited = 0.0
+
+    def run(self, ms):
+        self.proc.stdin.write(f"RUN {ms}\n")
+        self.proc.stdin.flush()
+        return int(self.proc.stdout.readline().split()[1])
+
+    def now_us(self):
+        # Serial input moves the clock on its own, so ask every time
+        return self.run(0)
+
+    def wait(self, seconds):
+        self.waited += seconds
+        self.run(int(round(seconds * 1000)))
+
+
+def transition_label(cmd):
+    """The visitor-facing name of a command, or None for settings and queries."""
+    word, _, rest = cmd.partition(' ')
+    if word == 'TEXT':
+        text, _, direction = rest.rpartition(' ')
+        return text if direction in ('LEFT', 'RIGHT', 'CENTER', 'FIT') else rest
+    if word == 'PATTERN':
+        return rest
+    if word in ('TOKEN', 'CLEAR'):
+        return word
+    return None
+
+
+class BenchDisplay(DisplayController):
+    """DisplayController that timestamps every command and its reply."""
+    def __init__(self, port, clock):
+        super().__init__(port)
+        self.clock = clock
+        self.sent_bytes = 0
+        self.sends = []        # {'label', 'end', 'sent', 'ack'}; end = bytes written incl. this one
+        self.pending = None
+
+    def send_command(self, cmd):
+        sent = self.clock.now_us()
+        ok = super().send_command(cmd)
+        self.sent_bytes += len(f"{cmd}\n".encode('utf-8'))
+        self.pending = {'label': transition_label(cmd), 'end': self.sent_bytes, 'sent': sent, 'ack': None}
+        self.sends.append(self.pending)
+        return ok
+
+    def read_response(self, timeout=1.0):
+        resp = super().read_response(timeout)
+        if resp and self.pending:
+            self.pending['ack'] = self.clock.now_us()
+            self.pending = None
+        return resp
+
+
+class ScriptedRfid:
+    """
+    A visitor per cycle: the figure is there as soon as the service looks,
+    its six tags are read over scan_s, and it is taken away removal_s after
+    the service first checks for it. Ends the service after `runs` cycles.
+    """
+    def __init__(self, clock, runs, scan_s, removal_s, quiet=False):
+        self.clock = clock
+        self.quiet = quiet
+        self.runs = runs
+        self.scan_s = scan_s
+        self.removal_s = removal_s
+        self.phase = 'idle'
+        self.cycles = []       # (now_us, waited_s) at the start of each cycle
+        self.removed_at = None
+
+    def has_tags_present(self):
+        now = self.clock.now_us()
+        if self.phase == 'idle':
+            self.cycles.append((now, self.clock.waited))
+            if len(self.cycles) > self.runs:
+                raise KeyboardInterrupt      # the service clears the display and returns
+            if not self.quiet:
+                print(f"run {len(self.cycles)}/{self.runs}", file=sys.stderr)
+            self.phase = 'placed'
+            return True
+        if self.phase == 'read':
+            self.phase = 'removing'
+            self.removed_at = now + self.removal_s * 1e6
+        if self.phase == 'removing' and now >= self.removed_at:
+            self.phase = 'idle'
+            return False
+        return True
+
+    def read_tags(self, target_tags=6, on_new_tag=None, **kwargs):
+        tags = []
+        for i in range(target_tags):
+            self.clock.wait(self.scan_s / target_tags)
+            tags.append({'epc': f"E2{i:022X}"})
+            if on_new_tag:
+                on_new_tag(len(tags), tags[-1])
+        self.phase = 'read'
+        return tags
+
+
+class ServiceTime:
+    """The service's `time` module, with sleep() on the benchmark clock."""
+    def __init__(self, clock):
+        self.clock = clock
+
+    def sleep(self, seconds):
+        self.clock.wait(seconds)
+
+    def __getattr__(self, name):
+        return getattr(time, name)
+
+
+def stub_modules(clock, ext):
+    class DataService:
+        def find_answer_by_tags(self, epcs):
+            return []
+
+        def calculate_answer_set_id(self, answers):
+            return 1
+
+        def get_total_unique_ids(self):
+            return 1
+
+    def generate_slip_data(**kwargs):
+        clock.wait(ext['generate'])
+        return {'offline_mode': True}
+
+    stubs = {name: types.ModuleType(name) for name in STUBBED_MODULES}
+    stubs['printer_controller'].auto_detect_printer = lambda: None
+    stubs['printer_controller'].PrinterController = lambda **kwargs: types.SimpleNamespace(printer=None)
+    stubs['slip_data_generation'].generate_slip_data = generate_slip_data
+    stubs['slip_printing'].create_full_receipt = lambda printer, slip_data: clock.wait(ext['print'])
+    stubs['supabase_upload'].upload_slip_data = lambda slip_data: None
+    stubs['supabase_upload'].build_qr_url = lambda data_id, figurine_id: ''
+    stubs['data_service'].DataService = DataService
+    stubs['content_generation'].GEMINI_MODEL = 'benchmark'
+    return stubs
+
+
+def run_service(display, rfid, clock, ext, quiet=False):
+    """figurine_service.main() with the benchmark's display, reader and clock."""
+    with mock.patch.dict(sys.modules, stub_modules(clock, ext)), \
+         mock.patch('logging.FileHandler', lambda *a, **k: logging.NullHandler()):
+        sys.modules.pop('figurine_service', None)
+        import figurine_service as service
+    logging.getLogger().handlers.clear()     # the service logs DEBUG to stdout
+    logging.getLogger().setLevel(logging.WARNING)
+
+    with mock.patch.multiple(service, connect_display=lambda priority=None: display,
+                             auto_detect_rfid=lambda: rfid, time=ServiceTime(clock),
+                             check_internet_connection=lambda: False, get_wifi_ssid=lambda: 'benchmark'), \
+         mock.patch.object(sys, 'argv', ['figurine_service.py']), \
+         open(os.devnull, 'w') as devnull, \
+         contextlib.redirect_stdout(devnull if quiet else sys.stderr):
+        service.main()
+
+
+def percentile(values, p):
+    if not values:
+        return None
+    s = sorted(values)
+    return s[min(len(s) - 1, int(round(p / 100 * (len(s) - 1))))]
+
+
+def fmt_ms(us):
+    return "      -" if us is None else f"{us / 1000:7.1f}"
+
+
+def read_events(path):
+    """("READ", us, bytes) and ("FRAME", us, None) in log order."""
+    events = []
+    with open(path) as f:
+        for line in f:
+            parts = line.split()
+            if parts and parts[0] == 'READ':
+                events.append(('READ', int(parts[1]), int(parts[2])))
+            elif parts and parts[0] == 'FRAME':
+                events.append(('FRAME', int(parts[1]), None))
+    return events
+
+
+def first_frames(sends, events):
+    """
+    For each labelled send, the time of the first frame after the firmware
+    read it and before it read the next labelled command, or None.
+    """
+    labelled = [s for s in sends if s['label']]
+    firsts = []
+    i = 0
+    for k, send in enumerate(labelled):
+        nxt = labelled[k + 1]['end'] if k + 1 < len(labelled) else float('inf')
+        while i < len(events) and not (events[i][0] == 'READ' and events[i][2] >= send['end']):
+            i += 1
+        first = None
+        for kind, us, n in events[i + 1:]:
+            if kind == 'READ' and n >= nxt:
+                break
+            if kind == 'FRAME':
+                first = us
+                break
+        firsts.append(first)
+    return labelled, firsts
+
+
+def run_benchmark(args):
+    events = tempfile.NamedTemporaryFile(prefix='display_frames_', suffix='.log', delete=False)
+    events.close()
+    cmd = [str(args.binary), '--pty', '--events', events.name]
+    if args.virtual:
+        cmd.append('--virtual')
+    proc = subprocess.Popen(cmd, stdin=subprocess.PIPE, stdout=subprocess.PIPE, text=True)
+    pty = proc.stdout.readline().split()[1]
+
+    clock = VirtualClock(proc) if args.virtual else RealClock(proc)
+    display = BenchDisplay(pty, clock)       # pays the 2 s "reset" wait once
+    ext = {'generate': args.generate_s, 'print': args.print_s}
+    rfid = ScriptedRfid(clock, args.runs, args.scan_s, args.removal_s, args.quiet)
+    try:
+        run_service(display, rfid, clock, ext, args.quiet)
+    finally:
+        display.close()
+        proc.stdin.close()
+        proc.wait(timeout=5)
+
+    log = read_events(events.name)
+    os.unlink(events.name)
+
+    results = {}
+    for send, first in zip(*first_frames(display.sends, log)):
+        r = results.setdefault(send['label'], {'ack': [], 'frame': [], 'missed': 0})
+        if send['ack'] is not None:
+            r['ack'].append(send['ack'] - send['sent'])
+        if first is None:
+            r['missed'] += 1
+        else:
+            r['frame'].append(first - send['sent'])
+
+    bounds = rfid.cycles
+    totals = [b[0] - a[0] for a, b in zip(bounds, bounds[1:])]
+    overhead = [b[0] - a[0] - (b[1] - a[1]) * 1e6 for a, b in zip(bounds, bounds[1:])]
+    return results, totals, overhead
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Visitor-cycle latency benchmark for the LED display')
+    parser.add_argument('--binary', type=Path, default=DEFAULT_BINARY, help='Host firmware (pio run -e native)')
+    parser.add_argument('--runs', type=int, default=20, help='Visitor cycles to run (default: 20)')
+    parser.add_argument('--virtual', action='store_true', help='Run the firmware on a virtual clock')
+    parser.add_argument('--scan-s', type=float, default=1.0, help='Time to read all six tags (default: 1.0)')
+    parser.add_argument('--generate-s', type=float, default=1.0, help='Content generation time to simulate (default: 1.0)')
+    parser.add_argument('--print-s', type=float, default=1.0, help='Receipt printing time to simulate (default: 1.0)')
+    parser.add_argument('--removal-s', type=float, default=1.0, help='Token removal time to simulate (default: 1.0)')
+    parser.add_argument('--json', type=Path, help='Also write the raw results here')
+    parser.add_argument('--quiet', action='store_true')
+    args = parser.parse_args()
+
+    if not args.binary.exists():
+        print(f"{args.binary} not found; build it with: cd display/hw && pio run -e native")
+        sys.exit(1)
+
+    results, totals, overhead = run_benchmark(args)
+
+    mode = 'virtual' if args.virtual else 'real'
+    print(f"\n{args.runs} visitor cycles, {mode} time (ms)")
+    print(f"{'transition':<15} {'ack p50':>8} {'p90':>7} {'p99':>7} | {'frame p50':>9} {'p90':>7} {'p99':>7} {'max':>7}  missed")
+    for label, r in results.items():
+        print(f"{label:<15} {fmt_ms(percentile(r['ack'], 50)):>8} {fmt_ms(percentile(r['ack'], 90))} "
+              f"{fmt_ms(percentile(r['ack'], 99))} | {fmt_ms(percentile(r['frame'], 50)):>9} "
+              f"{fmt_ms(percentile(r['frame'], 90))} {fmt_ms(percentile(r['frame'], 99))} "
+              f"{fmt_ms(max(r['frame'], default=None))}  {r['missed']}")
+    print(f"\ncycle total     p50 {fmt_ms(percentile(totals, 50))}  p99 {fmt_ms(percentile(totals, 99))}")
+    print(f"display share   p50 {fmt_ms(percentile(overhead, 50))}  p99 {fmt_ms(percentile(overhead, 99))}"
+          f"   (cycle minus scripted waits)")
+
+    if args.json:
+        args.json.write_text(json.dumps({
+            'mode': mode, 'runs': args.runs,
+            'transitions': results, 'cycle_us': totals, 'display_share_us': overhead,
+        }, indent=2))
+
+
+if __name__ == '__main__':
+    main()
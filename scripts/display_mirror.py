@@ -0,0 +1,57 @@
+#!/usr/bin/env python3
+"""
+Show what the LED display is currently showing, live, in the terminal.
+
+Turns on the firmware's framebuffer mirror (`MIRROR ON <hz>`) and redraws
+each decoded frame together with the measured serial bandwidth.
+
+Usage:
+    python scripts/display_mirror.py                 # auto-detect, 10 Hz
+    python scripts/display_mirror.py --port /dev/ttyACM0 --hz 20
+"""
+import argparse
+import sys
+import time
+from pathlib import Path
+
+# Add src to path for imports
+sys.path.insert(0, str(Path(__file__).parent.parent / 'src'))
+
+from display_controller import DisplayController, connect_display
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Mirror the LED display in the terminal')
+    parser.add_argument('--port', help='Serial port (default: auto-detect)')
+    parser.add_argument('--hz', type=int, default=10, help='Mirror rate, 1-25 (default: 10)')
+    args = parser.parse_args()
+
+    display = DisplayController(args.port) if args.port else connect_display()
+    if not display:
+        print("Display not found")
+        sys.exit(1)
+
+    display.set_mirror(args.hz)
+    decoder = display.mirror
+    shown = -1
+    start = time.time()
+    print("\033[2J", end='')
+    try:
+        while True:
+            display.read_response(timeout=0.05)   # feeds MF lines to the decoder
+            if decoder.frames == shown:
+                continue
+            shown = decoder.frames
+            elapsed = max(time.time() - start, 1e-3)
+            print("\033[H" + decoder.render_ascii(on='█', off='·'))
+            print(f"\nframes {decoder.frames}  dropped {decoder.dropped}  "
+                  f"{decoder.bytes / elapsed:6.0f} B/s   (Ctrl+C to quit)\033[K")
+    except KeyboardInterrupt:
+        pass
+    finally:
+        display.set_mirror(0)
+        display.close()
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,200 @@
+#!/usr/bin/env python3
+"""
+Pack fonts, messages and sprites into an asset bundle for the LED display.
+
+The bundle is flashed into the display's assets_a/assets_b partition over serial
+(ASSET BEGIN/DATA/COMMIT) and read in place by the firmware, so visual changes
+no longer need a firmware reflash. Format: display/hw/include/assets.h.
+
+Examples:
+    # German messages and a replacement tiny font
+    python scripts/pack_display_assets.py -o display_assets.bin \\
+        --text THINKING="DENKE NACH   " \\
+        --text REMOVE_FIGURE="BITTE FIGUR ENTFERNEN   " \\
+        --font 3X5=fonts/3x5.txt
+
+    # Build and upload in one go
+    python scripts/pack_display_assets.py -o display_assets.bin --sprite HEART=heart.gif:120 --upload auto
+
+Names the firmware looks up:
+    texts:  THINKING, FINISH, REMOVE_FIGURE, THANKS, VOILA
+    fonts:  5X7, 4X7, 3X5 (replace the built-in font of the same name)
+    sprites: any name, shown with `SPRITE <name>`
+
+Font files list the 64 glyphs for ASCII 32..95, each as a header line
+"<code> '<char>'" followed by one line per row ('#' = on, '.' = off).
+Sprites are animated GIFs, or PNG strips of 8-pixel-high frames stacked vertically.
+"""
+import argparse
+import struct
+import sys
+import zlib
+from pathlib import Path
+
+# Add src to path for imports
+sys.path.insert(0, str(Path(__file__).parent.parent / 'src'))
+
+MAGIC = 0x53414746          # "FGAS"
+VERSION = 1
+SEQ_UNSET = 0xFFFFFFFF      # stamped by the device on commit
+SLOT_SIZE = 0x10000
+NAME_LEN = 16
+GLYPHS = 64
+DISPLAY_WIDTH = 32
+
+ASSET_FONT = 1
+ASSET_TEXT = 2
+ASSET_SPRITE = 3
+
+HEADER = struct.Struct('<IHHIII12x')
+ENTRY = struct.Struct('<16sB3xII')
+
+
+def load_font(path: Path) -> bytes:
+    """Parse a glyph grid file into an ASSET_FONT payload."""
+    lines = [l.rstrip('\n') for l in path.read_text().splitlines()]
+    glyphs = []
+    i = 0
+    while i < len(lines):
+        if not lines[i].strip():
+            i += 1
+            continue
+        code = int(lines[i].split()[0])
+        rows = []
+        i += 1
+        while i < len(lines) and lines[i] and set(lines[i]) <= {'#', '.'}:
+            rows.append(lines[i])
+            i += 1
+        glyphs.append((code, rows))
+
+    if [g[0] for g in glyphs] != list(range(32, 32 + GLYPHS)):
+        raise ValueError(f"{path}: expected glyphs for ASCII 32..95 in order")
+    height = len(glyphs[0][1])
+    width = len(glyphs[0][1][0])
+    if not (1 <= width <= 15 and 1 <= height <= 8):
+        raise ValueError(f"{path}: glyphs must be at most 15x8")
+    for code, rows in glyphs:
+        if len(rows) != height or any(len(r) != width for r in rows):
+            raise ValueError(f"{path}: glyph {code} is not {width}x{height}")
+
+    # Same packing as PackedFont in include/fonts.h
+    bits = bytearray((GLYPHS * width * height + 7) // 8 + 1)
+    spans = bytearray(GLYPHS)
+    for g, (_, rows) in enumerate(glyphs):
+        lit = []
+        for c in range(width):
+            col = 0
+            for r in range(height):
+                if rows[r][c] == '#':
+                    col |= 1 << r
+                    bit = (g * width + c) * height + r
+                    bits[bit >> 3] |= 1 << (bit & 7)
+            if col:
+                lit.append(c)
+        spans[g] = 0xFF if not lit else (lit[0] << 4) | lit[-1]
+
+    y_offset = (8 - height) // 2 if height < 7 else 0
+    space_width = width // 2 + 1
+    return bytes([width, height, y_offset, space_width]) + bytes(bits) + bytes(spans)
+
+
+def load_sprite(path: Path, frame_ms: int) -> bytes:
+    """Convert a GIF or a PNG strip into an ASSET_SPRITE payload."""
+    from PIL import Image, ImageSequence
+
+    img = Image.open(path)
+    frames = []
+    if getattr(img, 'n_frames', 1) > 1:
+        frames = [f.convert('L') for f in ImageSequence.Iterator(img)]
+    else:
+        img = img.convert('L')
+        if img.height % 8:
+            raise ValueError(f"{path}: strip height must be a multiple of 8")
+        frames = [img.crop((0, y, img.width, y + 8)) for y in range(0, img.height, 8)]
+
+    width = frames[0].width
+    if width > DISPLAY_WIDTH or any(f.size != (width, 8) for f in frames):
+        raise ValueError(f"{path}: frames must be 8 px high and at most {DISPLAY_WIDTH} px wide")
+
+    data = bytearray(struct.pack('<HHB3x', len(frames), frame_ms, width))
+    for frame in frames:
+        px = frame.load()
+        for x in range(width):
+            col = 0
+            for y in range(8):
+                if px[x, y] > 127:
+                    col |= 1 << y  # LSB = top row
+            data.append(col)
+    return bytes(data)
+
+
+def build_bundle(entries) -> bytes:
+    """entries: list of (name, type, payload). Returns the packed bundle."""
+    entries = sorted(entries, key=lambda e: e[0].encode('ascii'))
+    names = [e[0] for e in entries]
+    if len(set(names)) != len(names):
+        raise ValueError("duplicate asset names")
+
+    offset = HEADER.size + ENTRY.size * len(entries)
+    index = bytearray()
+    payloads = bytearray()
+    for name, kind, payload in entries:
+        if len(name) >= NAME_LEN:
+            raise ValueError(f"asset name too long: {name}")
+        pad = (-(offset + len(payloads))) % 4
+        payloads += b'\0' * pad
+        index += ENTRY.pack(name.encode('ascii'), kind, offset + len(payloads), len(payload))
+        payloads += payload
+
+    body = bytes(index + payloads)
+    size = HEADER.size + len(body)
+    if size > SLOT_SIZE:
+        raise ValueError(f"bundle is {size} bytes, slot holds {SLOT_SIZE}")
+    header = HEADER.pack(MAGIC, VERSION, len(entries), SEQ_UNSET, size, zlib.crc32(body))
+    return header + body
+
+
+def parse_pair(arg: str):
+    if '=' not in arg:
+        raise argparse.ArgumentTypeError(f"expected NAME=VALUE, got {arg!r}")
+    name, value = arg.split('=', 1)
+    return name.strip().upper(), value
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Pack display assets into a flashable bundle')
+    parser.add_argument('-o', '--output', type=Path, required=True, help='Bundle file to write')
+    parser.add_argument('--text', type=parse_pair, action='append', default=[], help='NAME=message')
+    parser.add_argument('--font', type=parse_pair, action='append', default=[], help='NAME=glyph file')
+    parser.add_argument('--sprite', type=parse_pair, action='append', default=[],
+                        help='NAME=image[:frame_ms] (GIF or PNG strip)')
+    parser.add_argument('--upload', metavar='PORT', help="Upload to the display ('auto' to detect)")
+    args = parser.parse_args()
+
+    entries = []
+    for name, text in args.text:
+        entries.append((name, ASSET_TEXT, text.upper().encode('latin-1') + b'\0'))
+    for name, path in args.font:
+        entries.append((name, ASSET_FONT, load_font(Path(path))))
+    for name, spec in args.sprite:
+        path, _, ms = spec.partition(':')
+        entries.append((name, ASSET_SPRITE, load_sprite(Path(path), int(ms or 100))))
+
+    bundle = build_bundle(entries)
+    args.output.write_bytes(bundle)
+    print(f"Wrote {args.output}: {len(entries)} assets, {len(bundle)} bytes, crc32={zlib.crc32(bundle[HEADER.size:]):08X}")
+
+    if args.upload:
+        from display_controller import DisplayController, connect_display
+        display = connect_display() if args.upload == 'auto' else DisplayController(args.upload)
+        if not display:
+            print("Display not found")
+            sys.exit(1)
+        ok = display.upload_assets(bundle)
+        display.close()
+        print("Upload OK" if ok else "Upload FAILED")
+        sys.exit(0 if ok else 1)
+
+
+if __name__ == '__main__':
+    main()
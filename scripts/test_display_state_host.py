@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+"""
+STATE LOAD range checks against the host-native firmware.
+
+Dumps the display in a few scrolling states, checks each dump loads back,
+then loads CRC-valid copies with the scroll position or width pushed out of
+range and expects "ERR STATE RANGE" (an out-of-range STRIP position used to
+read past the strip, and a zero LOOP width never wraps).
+
+Build the firmware for the host first:
+    cd display/hw && pio run -e native
+
+Usage:
+    python scripts/test_display_state_host.py [--binary PATH]
+"""
+import argparse
+import struct
+import subprocess
+import sys
+import zlib
+from pathlib import Path
+
+# Add src to path for imports
+sys.path.insert(0, str(Path(__file__).parent.parent / 'src'))
+
+from display_controller import DisplayController
+import display_state
+
+DEFAULT_BINARY = Path(__file__).parent.parent / 'display' / 'hw' / '.pio' / 'build' / 'native' / 'program'
+
+SCROLL_X = 8        # i16 offsets in the snapshot, see display_state._HEADER
+TEXT_PX = 14
+
+
+def patched(blob, **fields):
+    """blob with scroll_x / text_px replaced and the CRC redone."""
+    b = bytearray(blob)
+    if 'scroll_x' in fields:
+        struct.pack_into('<h', b, SCROLL_X, fields['scroll_x'])
+    if 'text_px' in fields:
+        struct.pack_into('<h', b, TEXT_PX, fields['text_px'])
+    struct.pack_into('<I', b, len(b) - 4, zlib.crc32(b[:-4]) & 0xFFFFFFFF)
+    return bytes(b)
+
+
+def load(display, blob):
+    display.send_command(f"STATE LOAD {blob.hex().upper()}")
+    return display.read_response()
+
+
+def main():
+    parser = argparse.ArgumentParser(description='STATE LOAD range checks on the host build')
+    parser.add_argument('--binary', type=Path, default=DEFAULT_BINARY, help='Host firmware (pio run -e native)')
+    args = parser.parse_args()
+
+    if not args.binary.exists():
+        print(f"{args.binary} not found; build it with: cd display/hw && pio run -e native")
+        sys.exit(1)
+
+    proc = subprocess.Popen([str(args.binary), '--pty'], stdin=subprocess.PIPE, stdout=subprocess.PIPE, text=True)
+    display = DisplayController(proc.stdout.readline().split()[1])
+
+    def text(msg, direction):
+        return lambda: display.set_text(msg, direction=direction)
+
+    def strip(mode):
+        return lambda: display.show_strip(bytes((i * 37) & 0xFF for i in range(48)), mode)
+
+    # (setup, [(name, fields)]): the dump must load back, every patched copy
+    # must come back ERR STATE RANGE
+    cases = [
+        (strip('LOOP'), [
+            ('strip loop x = width', lambda s: {'scroll_x': s['text_px']}),
+            ('strip loop x < 0', lambda s: {'scroll_x': -1}),
+            ('strip width 0', lambda s: {'text_px': 0, 'scroll_x': 0}),
+            ('strip width != strip', lambda s: {'text_px': s['text_px'] + 1}),
+        ]),
+        (strip('LEFT'), [
+            ('strip left x < -width', lambda s: {'scroll_x': -s['text_px'] - 1}),
+            ('strip left x > panel', lambda s: {'scroll_x': display_state.DISPLAY_WIDTH + 1}),
+        ]),
+        (text('HELLO WORLD', 'LEFT'), [
+            ('text x < -width', lambda s: {'scroll_x': -s['text_px'] - 1}),
+            ('text x > panel', lambda s: {'scroll_x': 1000}),
+            ('text width != measured', lambda s: {'text_px': s['text_px'] - 1}),
+        ]),
+        # FIT and centred text keep the width fitText() measured
+        (text('HI', 'FIT'), []),
+        (text('REMOVE FIGURE', 'FIT'), []),
+        (text('HELLO', None), []),
+        (lambda: display.set_pattern('THINKING'), [
+            ('scroller x > panel', lambda s: {'scroll_x': display_state.DISPLAY_WIDTH + 1}),
+            ('scroller x < -width', lambda s: {'scroll_x': -1000}),
+        ]),
+    ]
+
+    failures = 0
+    try:
+        for setup, bad in cases:
+            setup()
+            blob = display.dump_state()
+            state = display_state.decode(blob)
+            resp = load(display, blob)
+            ok = resp == "OK"
+            failures += not ok
+            print(f"{'PASS' if ok else 'FAIL'}  {state['pattern']} {state['scroll']} round trip: {resp}")
+            for name, fields in bad:
+                resp = load(display, patched(blob, **fields(state)))
+                ok = resp == "ERR STATE RANGE"
+                failures += not ok
+                print(f"{'PASS' if ok else 'FAIL'}  {name}: {resp}")
+    finally:
+        display.close()
+        proc.stdin.close()
+        proc.wait(timeout=5)
+
+    print(f"\n{failures} failure(s)")
+    sys.exit(1 if failures else 0)
+
+
+if __name__ == '__main__':
+    main()
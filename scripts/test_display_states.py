@@ -4,10 +4,17 @@ Test script for the LED Display states.
 Allows interactive testing of all display patterns.
 """
 
+import os
 import sys
 import time
 import glob
 import serial
+from pathlib import Path
+
+# Add src to path for imports
+sys.path.insert(0, str(Path(__file__).parent.parent / 'src'))
+
+from display_controller import DAEMON_SOCKET, DaemonDisplay
 
 def get_serial_port():
     """Auto-detect or ask for serial port."""
@@ -31,17 +38,31 @@ def get_serial_port():
 
 def main():
     print("=== Display State Tester ===")
-    port = get_serial_port()
-    if not port:
-        sys.exit(1)
-        
-    print(f"Connecting to {port}...")
-    try:
-        ser = serial.Serial(port, 115200, timeout=1)
-        time.sleep(2) # Wait for reset
-    except Exception as e:
-        print(f"Error opening port: {e}")
-        sys.exit(1)
+    ser = None
+    daemon = None
+    if os.path.exists(DAEMON_SOCKET):
+        # The display daemon owns the port; talk to it instead
+        print(f"Connecting to display daemon at {DAEMON_SOCKET}...")
+        daemon = DaemonDisplay(DAEMON_SOCKET)
+    else:
+        port = get_serial_port()
+        if not port:
+            sys.exit(1)
+
+        print(f"Connecting to {port}...")
+        try:
+            ser = serial.Serial(port, 115200, timeout=1)
+            time.sleep(2) # Wait for reset
+        except Exception as e:
+            print(f"Error opening port: {e}")
+            sys.exit(1)
+
+    def send(cmd):
+        if daemon:
+            daemon.send_command(cmd)
+        else:
+            ser.write(f"{cmd}\n".encode())
+        print(f"Sent: {cmd}")
         
     print("\nConnected!")
     print("Commands:")
@@ -59,34 +80,35 @@ def main():
         if cmd == 'q':
             break
         elif cmd == '1':
-            ser.write(b"PATTERN BORED\n")
-            print("Sent: PATTERN BORED")
+            send("PATTERN BORED")
         elif cmd == '2':
-            ser.write(b"PATTERN THINKING\n")
-            print("Sent: PATTERN THINKING")
+            send("PATTERN THINKING")
         elif cmd == '3':
-            ser.write(b"PATTERN FINISH\n")
-            print("Sent: PATTERN FINISH")
+            send("PATTERN FINISH")
         elif cmd == '4':
-            ser.write(b"PATTERN REMOVE_FIGURE\n")
-            print("Sent: PATTERN REMOVE_FIGURE")
+            send("PATTERN REMOVE_FIGURE")
         elif cmd == '5':
-            ser.write(b"CLEAR\n")
-            print("Sent: CLEAR")
+            send("CLEAR")
         elif cmd == '6':
             try:
                 val = int(input("Brightness (0-15): "))
-                ser.write(f"BRIGHT {val}\n".encode())
-                print(f"Sent: BRIGHT {val}")
+                send(f"BRIGHT {val}")
             except:
                 print("Invalid number")
         
         # Read response
+        if daemon:
+            if cmd in "123456":
+                print(f"RX: {daemon.read_response()}")
+            continue
         time.sleep(0.1)
         while ser.in_waiting:
             print(f"RX: {ser.readline().decode().strip()}")
 
-    ser.close()
+    if daemon:
+        daemon.close()
+    else:
+        ser.close()
 
 if __name__ == "__main__":
     main()
@@ -20,7 +20,7 @@ print("1. Testing imports...")
 try:
     from printer_controller import PrinterController, auto_detect_printer
     from slip_printing import ReceiptRenderer
-    from display_controller import auto_detect_display
+    from display_controller import connect_display
     from rfid_controller import auto_detect_rfid
     from google import genai
     from dotenv import load_dotenv
@@ -47,7 +47,7 @@ else:
 
 # Display
 print("   Checking Display...")
-display = auto_detect_display()
+display = connect_display()
 if display:
     print("   ✓ Display detected")
     test_results["Display"] = "CONNECTED"
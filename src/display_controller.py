@@ -2,14 +2,64 @@ import serial
 import time
 import glob
 import logging
+import os
+import socket
+from collections import deque
+
+from display_mirror import MirrorDecoder
 
 logger = logging.getLogger(__name__)
 
+# Unix socket of src/display_daemon.py
+DAEMON_SOCKET = os.environ.get('FIGURINE_DISPLAY_SOCKET', '/tmp/figurine-display.sock')
+
+# First byte of unsolicited lines (display/hw/include/channels.h); responses
+# start with OK or ERR
+EVENT_PREFIX = '!'
+LOG_PREFIX = '#'
+
+# Command log for replay on the host build, strftime patterns allowed,
+# e.g. /var/log/figurine/display-%Y%m%d-%H%M%S.log
+CAPTURE_FILE = os.environ.get('FIGURINE_DISPLAY_CAPTURE')
+
+class CommandCapture:
+    """
+    Logs every command sent to the display as "<ms> <command>", ms counted
+    from when the port was opened. One file per connection, since opening
+    the port resets the display; a reconnect that expands to an existing
+    name gets a -2, -3, ... suffix instead of overwriting it. Replay with
+    the host build:
+        .pio/build/native/program --replay <log>
+    """
+    def __init__(self, path, start=None):
+        name = time.strftime(path)
+        root, ext = os.path.splitext(name)
+        n = 1
+        while True:
+            self.path = name if n == 1 else f"{root}-{n}{ext}"
+            try:
+                self.f = open(self.path, 'x', buffering=1)
+                break
+            except FileExistsError:
+                n += 1
+        self.f.write(f"# display capture {time.strftime('%Y-%m-%d %H:%M:%S')}\n")
+        self.start = time.monotonic() if start is None else start
+
+    def record(self, cmd):
+        self.f.write(f"{int((time.monotonic() - self.start) * 1000)} {cmd}\n")
+
+    def close(self):
+        self.f.close()
+
 class DisplayController:
     def __init__(self, port, baud=115200):
+        opened = time.monotonic()      # the display resets here; captures count from it
         self.ser = serial.Serial(port, baud, timeout=1)
+        self.mirror = None   # MirrorDecoder while MIRROR is on
+        self.events = deque(maxlen=64)   # unread events, without the '!'
         time.sleep(2) # Wait for ESP32 reset
         self.clear_buffer()
+        self.capture = CommandCapture(CAPTURE_FILE, opened) if CAPTURE_FILE else None
 
     def clear_buffer(self):
         self.ser.reset_input_buffer()
@@ -18,8 +68,16 @@ class DisplayController:
         if not self.ser.is_open:
             return False
         try:
+            # Anything still waiting is from before this command: route the
+            # events, and drop late responses so they can't answer this one
+            while self.ser.in_waiting:
+                stale = self.route(self.ser.readline().decode('utf-8', errors='ignore').strip())
+                if stale:
+                    logger.warning(f"Display: unread response {stale!r}")
             full_cmd = f"{cmd}\n".encode('utf-8')
             self.ser.write(full_cmd)
+            if self.capture:
+                self.capture.record(cmd)
             return True
         except Exception as e:
             logger.error(f"Display send error: {e}")
@@ -30,11 +88,10 @@ class DisplayController:
             return None
         
         start = time.time()
-        response = ""
         while time.time() - start < timeout:
             if self.ser.in_waiting:
                 try:
-                    line = self.ser.readline().decode('utf-8').strip()
+                    line = self.route(self.ser.readline().decode('utf-8').strip())
                     if line:
                         return line
                 except Exception:
@@ -42,6 +99,39 @@ class DisplayController:
             time.sleep(0.01)
         return None
 
+    def route(self, line):
+        """
+        Returns `line` if it is a command response (OK/ERR). Events are fed to
+        the mirror or queued in self.events, logs go to the logger.
+        """
+        if not line:
+            return None
+        if line[0] == EVENT_PREFIX:
+            if MirrorDecoder.is_frame(line):
+                if self.mirror:
+                    self.mirror.feed(line)
+            else:
+                self.events.append(line[1:])
+            return None
+        if line.startswith("OK") or line.startswith("ERR"):
+            return line
+        # Log lines, and boot noise from before the firmware started
+        logger.debug(f"Display: {line.lstrip(LOG_PREFIX)}")
+        return None
+
+    def read_event(self, timeout=1.0):
+        """
+        Next event such as 'SELFTEST LEDS 12/256' or 'PATTERN SNAKE', or None.
+        """
+        start = time.time()
+        while not self.events:
+            remaining = timeout - (time.time() - start)
+            if remaining <= 0:
+                return None
+            # Only events are expected here; a stray response is dropped
+            self.read_response(timeout=remaining)
+        return self.events.popleft()
+
     def set_pattern(self, pattern):
         """
         Set display pattern: SNAKE, THINKING, FINISH, PRINTING, ERROR, REMOVE_FIGURE
@@ -60,7 +150,8 @@ class DisplayController:
         
         Args:
             text (str): Text to display (max 64 characters)
-            direction (str): Optional scrolling direction: 'LEFT', 'RIGHT', or None for centered
+            direction (str): Optional scrolling direction: 'LEFT', 'RIGHT', 'FIT', or None for centered.
+                'FIT' lets the display pick the largest font that fits and scroll only if needed
         
         Returns:
             bool: True if command was acknowledged
@@ -69,7 +160,7 @@ class DisplayController:
             logger.warning(f"Text too long ({len(text)} chars), truncating to 64")
             text = text[:64]
         
-        if direction and direction.upper() in ['LEFT', 'RIGHT', 'CENTER']:
+        if direction and direction.upper() in ['LEFT', 'RIGHT', 'CENTER', 'FIT']:
             cmd = f"TEXT {text} {direction.upper()}"
         else:
             cmd = f"TEXT {text}"
@@ -78,6 +169,162 @@ class DisplayController:
         resp = self.read_response()
         return resp == "OK"
     
+    def self_test(self, name="ALL", fast=False):
+        """
+        Start a module self-test: LEDS, ALLON, ROWS, COLUMNS, MODULES, CHECKER, CORNERS or ALL.
+        Runs on the device in the background; progress arrives as 'SELFTEST ...'
+        events, see read_event().
+        """
+        cmd = f"SELFTEST {name.upper()}"
+        if fast:
+            cmd += " FAST"
+        self.send_command(cmd)
+        resp = self.read_response()
+        return resp == "OK"
+
+    def upload_assets(self, bundle, chunk_size=96):
+        """
+        Flash an asset bundle (see scripts/pack_display_assets.py) into the
+        display's inactive asset slot. The display switches to it on commit.
+
+        Returns:
+            bool: True if the display accepted and mounted the bundle
+        """
+        import zlib
+        body_crc = zlib.crc32(bundle[32:]) & 0xFFFFFFFF
+        self.send_command(f"ASSET BEGIN {len(bundle)} {body_crc:08X}")
+        resp = self.read_response(timeout=2.0)
+        if resp != "OK":
+            logger.error(f"Asset upload rejected: {resp}")
+            return False
+
+        for offset in range(0, len(bundle), chunk_size):
+            chunk = bundle[offset:offset + chunk_size]
+            self.send_command(f"ASSET DATA {offset} {chunk.hex().upper()}")
+            resp = self.read_response(timeout=2.0)
+            if resp != "OK":
+                logger.error(f"Asset upload failed at offset {offset}: {resp}")
+                self.send_command("ASSET ABORT")
+                self.read_response(timeout=2.0)
+                return False
+
+        self.send_command("ASSET COMMIT")
+        resp = self.read_response(timeout=5.0)
+        if resp != "OK":
+            logger.error(f"Asset commit failed: {resp}")
+            return False
+        return True
+
+    def show_strip(self, columns, mode=None, chunk_size=96):
+        """
+        Upload a bitmap strip (see display_strip.py) and show it.
+
+        Args:
+            columns (bytes): one byte per column, LSB = top row
+            mode (str): 'CENTER', 'LEFT', 'RIGHT', 'LOOP', or None to centre
+                if it fits and scroll left otherwise
+
+        Returns:
+            bool: True if the display accepted and shows the strip
+        """
+        import zlib
+        crc = zlib.crc32(columns) & 0xFFFFFFFF
+        self.send_command(f"STRIP BEGIN {len(columns)} {crc:08X}")
+        resp = self.read_response(timeout=2.0)
+        if resp != "OK":
+            logger.error(f"Strip upload rejected: {resp}")
+            return False
+
+        for offset in range(0, len(columns), chunk_size):
+            chunk = columns[offset:offset + chunk_size]
+            self.send_command(f"STRIP DATA {offset} {chunk.hex().upper()}")
+            resp = self.read_response(timeout=2.0)
+            if resp != "OK":
+                logger.error(f"Strip upload failed at {offset}: {resp}")
+                return False
+
+        self.send_command(f"STRIP SHOW {mode.upper()}" if mode else "STRIP SHOW")
+        return self.read_response(timeout=2.0) == "OK"
+
+    def set_token(self, n, on=True):
+        """
+        Light (or clear) segment n (1-6) of the PROGRESS6 pattern, switching to
+        it if needed. The display measures command-to-pixel latency, see
+        token_stats().
+        """
+        self.send_command(f"TOKEN {n} {'ON' if on else 'OFF'}")
+        return self.read_response() == "OK"
+
+    def token_stats(self):
+        """
+        TOKEN latency on the display, from the first byte of the command to the
+        segment being flushed: {'N': count, 'LAST_US': .., 'MAX_US': .., 'AVG_US': ..}
+        """
+        self.send_command("TOKEN STATS")
+        resp = self.read_response()
+        if not resp or not resp.startswith("OK TOKEN "):
+            return None
+        return {k: int(v) for k, v in (f.split('=') for f in resp.split()[2:])}
+
+    def dump_state(self):
+        """
+        Snapshot of everything the display is showing (STATE DUMP), as bytes
+        for load_state(); display_state.decode() reads it. None on failure.
+        """
+        self.send_command("STATE DUMP")
+        resp = self.read_response()
+        if not resp or not resp.startswith("OK STATE "):
+            logger.error(f"State dump failed: {resp}")
+            return None
+        return bytes.fromhex(resp[9:])
+
+    def load_state(self, blob):
+        """
+        Put the display back into a dump_state() snapshot in one step, without
+        clearing it first. Fails (and changes nothing) if the snapshot is
+        corrupt or refers to a strip or sprite the display no longer has.
+        """
+        self.send_command(f"STATE LOAD {blob.hex().upper()}")
+        resp = self.read_response()
+        if resp != "OK":
+            logger.error(f"State load rejected: {resp}")
+            return False
+        return True
+
+    def show_overlay(self, text, ms=2000, layer=1, blend=None):
+        """
+        Show text on top of the running pattern for `ms` (0 = until
+        hide_overlay()); the pattern keeps running underneath.
+
+        Args:
+            layer (int): 1-3, higher layers are drawn on top
+            blend (str): 'BOX' (default, text on a cleared box), 'OR', 'XOR'
+                or 'ERASE'
+        """
+        mode = f" {blend.upper()}" if blend else ""
+        self.send_command(f"OVERLAY {layer} {int(ms)}{mode} {text}")
+        return self.read_response() == "OK"
+
+    def hide_overlay(self, layer=None):
+        """Remove one overlay layer, or all of them."""
+        self.send_command(f"OVERLAY {layer or 'ALL'} OFF")
+        return self.read_response() == "OK"
+
+    def set_mirror(self, hz=10):
+        """
+        Mirror the framebuffer back at up to `hz` frames/s (0 turns it off).
+        The latest frame is available as self.mirror.columns / render_ascii().
+        """
+        if hz:
+            self.mirror = MirrorDecoder()
+            self.send_command(f"MIRROR ON {hz}")
+        else:
+            self.send_command("MIRROR OFF")
+        resp = self.read_response()
+        if not hz:
+            self.mirror = None
+        return bool(resp and resp.startswith("OK MIRROR"))
+
     def set_brightness(self, level):
         """
         Set brightness level (0-15).
@@ -85,7 +332,7 @@ class DisplayController:
         level = max(0, min(15, level))
         self.send_command(f"BRIGHT {level}")
         resp = self.read_response()
-        return resp == "OK"
+        return bool(resp and resp.startswith("OK"))
     
     def set_speed(self, speed):
         """
@@ -94,18 +341,20 @@ class DisplayController:
         speed = max(1, min(10, speed))
         self.send_command(f"SPEED {speed}")
         resp = self.read_response()
-        return resp == "OK"
+        return bool(resp and resp.startswith("OK"))
 
     def clear(self):
         """
         Clear the display or reset to default state.
         """
         self.send_command("CLEAR")
-        return True
+        return self.read_response() == "OK"
 
     def close(self):
         if self.ser.is_open:
             self.ser.close()
+        if self.capture:
+            self.capture.close()
 
 def auto_detect_display():
     """
@@ -151,3 +400,88 @@ def auto_detect_display():
             pass
     
     return None
+
+
+class DaemonDisplay(DisplayController):
+    """
+    DisplayController that talks to display_daemon.py instead of the serial
+    port. Same methods; connecting takes well under a millisecond.
+    """
+    def __init__(self, path=DAEMON_SOCKET, priority='DIAGNOSTICS'):
+        self.sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        self.sock.connect(path)
+        self.buf = b''
+        self.mirror = None
+        self.events = deque(maxlen=64)
+        self.send_command(f"@PRIORITY {priority}")
+        if self.read_response() != f"OK PRIORITY={priority}":
+            self.sock.close()
+            raise ConnectionError("display daemon did not accept priority")
+
+    def clear_buffer(self):
+        pass
+
+    def send_command(self, cmd):
+        try:
+            # As on the serial port: whatever arrived before this command is
+            # routed, and late responses are dropped so they can't answer it
+            self.sock.setblocking(False)
+            try:
+                while data := self.sock.recv(4096):
+                    self.buf += data
+            except BlockingIOError:
+                pass
+            finally:
+                self.sock.setblocking(True)
+            while b'\n' in self.buf:
+                raw, self.buf = self.buf.split(b'\n', 1)
+                stale = self.route(raw.decode('utf-8', errors='ignore').strip())
+                if stale:
+                    logger.warning(f"Display: unread response {stale!r}")
+            self.sock.sendall(f"{cmd}\n".encode('utf-8'))
+            return True
+        except OSError as e:
+            logger.error(f"Display daemon send error: {e}")
+            return False
+
+    def read_response(self, timeout=2.0):
+        # The daemon answers after the display does, allow for its queue
+        deadline = time.time() + timeout
+        while True:
+            while b'\n' in self.buf:
+                raw, self.buf = self.buf.split(b'\n', 1)
+                line = self.route(raw.decode('utf-8', errors='ignore').strip())
+                if line:
+                    return line
+            remaining = deadline - time.time()
+            if remaining <= 0:
+                return None
+            try:
+                self.sock.settimeout(remaining)
+                data = self.sock.recv(4096)
+            except (socket.timeout, OSError):
+                return None
+            if not data:
+                return None
+            self.buf += data
+
+    def set_mirror(self, hz=10):
+        self.send_command(f"@SUBSCRIBE {'ON' if hz else 'OFF'}")
+        self.read_response()
+        return super().set_mirror(hz)
+
+    def close(self):
+        self.sock.close()
+
+
+def connect_display(priority='DIAGNOSTICS'):
+    """
+    Connect through the display daemon if it is running, otherwise open the
+    serial port directly.
+    """
+    if os.path.exists(DAEMON_SOCKET):
+        try:
+            return DaemonDisplay(DAEMON_SOCKET, priority)
+        except OSError as e:
+            logger.warning(f"Display daemon not reachable ({e}), opening serial port")
+    return auto_detect_display()
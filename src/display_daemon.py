@@ -0,0 +1,326 @@
+#!/usr/bin/env python3
+"""
+Display daemon: owns the LED display's serial port and shares it with
+any number of local clients over a Unix socket.
+
+Opening the port resets the ESP32 (2 s), and only one process can hold it.
+The daemon keeps it open, so clients connect in well under a millisecond
+and the service, test scripts and diagnostics no longer fight over it.
+
+Protocol (one line per request, one line per reply):
+    <serial command>        forwarded to the display, e.g. "TEXT HI FIT";
+                            the reply is the display's OK/ERR line
+    @PRIORITY <name>        SERVICE or DIAGNOSTICS (default) for this connection
+    @SUBSCRIBE ON|OFF       also receive the display's events ("!..." lines:
+                            mirror frames, SELFTEST progress, PATTERN ...)
+    @PING                   "OK PONG" without touching the display
+
+Arbitration:
+    - Queued commands run highest priority first, FIFO within a priority.
+    - Commands that change what is shown (TEXT, PATTERN, BRIGHT, ...) are
+      refused with "ERR BUSY" while a higher-priority client that changed the
+      display is still connected.
+    - Queued commands of the same kind are coalesced: if several TEXT/PATTERN
+      commands are waiting, only the latest is sent and every waiting client
+      gets its reply.
+
+Usage:
+    python src/display_daemon.py [--port /dev/ttyACM0] [--socket PATH]
+Clients: display_controller.connect_display()
+"""
+import argparse
+import itertools
+import logging
+import os
+import socket
+import socketserver
+import threading
+import time
+
+from display_controller import DAEMON_SOCKET, EVENT_PREFIX, DisplayController, auto_detect_display
+
+logger = logging.getLogger(__name__)
+
+PRIORITIES = {'DIAGNOSTICS': 1, 'SERVICE': 2}
+
+# Commands that decide what is on screen; only the latest queued one matters
+CONTENT_COMMANDS = ('TEXT', 'PATTERN', 'SPRITE', 'SELFTEST', 'CLEAR', 'STOP')
+# Commands that change the display and are subject to priority ownership
+# (STRIP uploads span several lines, so they are never coalesced)
+OWNED_COMMANDS = CONTENT_COMMANDS + ('BRIGHT', 'SPEED', 'ASSET', 'STRIP', 'OVERLAY', 'TOKEN')
+
+RESPONSE_TIMEOUT = 2.0
+COMMIT_TIMEOUT = 5.0
+KEEPALIVE_INTERVAL = 30.0
+RECONNECT_INTERVAL = 5.0
+
+
+def sd_notify(state):
+    """Tell systemd (Type=notify) about our state; a no-op outside systemd."""
+    path = os.environ.get('NOTIFY_SOCKET')
+    if not path:
+        return
+    if path.startswith('@'):
+        path = '\0' + path[1:]
+    try:
+        with socket.socket(socket.AF_UNIX, socket.SOCK_DGRAM) as s:
+            s.sendto(state.encode('utf-8'), path)
+    except OSError as e:
+        logger.warning(f"sd_notify failed: {e}")
+
+
+def command_word(line):
+    return line.split(' ', 1)[0].upper()
+
+
+def is_owned(line):
+    # STATE DUMP is a query anyone may send; STATE LOAD replaces the screen
+    if line[:10].upper() == 'STATE LOAD':
+        return True
+    return command_word(line) in OWNED_COMMANDS
+
+
+def coalesce_key(line):
+    word = command_word(line)
+    if word in CONTENT_COMMANDS:
+        return 'CONTENT'
+    if word in ('BRIGHT', 'SPEED'):
+        return word
+    return None
+
+
+class Request:
+    _seq = itertools.count()
+
+    def __init__(self, client, line, priority):
+        self.line = line
+        self.priority = priority
+        self.key = coalesce_key(line)
+        self.waiters = [client]
+        self.seq = next(Request._seq)
+
+
+class DisplayDaemon:
+    def __init__(self, port=None):
+        self.port = port
+        self.display = None
+        self.queue = []
+        self.cond = threading.Condition()
+        self.clients = set()
+        self.owner = None            # client that last changed the display
+        self.running = True
+        self.last_io = 0.0
+        self.next_connect = 0.0
+
+    # --- serial side ------------------------------------------------------
+    def connect(self):
+        if self.display:
+            return True
+        if time.time() < self.next_connect:
+            return False
+        self.next_connect = time.time() + RECONNECT_INTERVAL
+        try:
+            self.display = DisplayController(self.port) if self.port else auto_detect_display()
+        except Exception as e:
+            logger.warning(f"Display not available on {self.port}: {e}")
+            self.display = None
+        if self.display:
+            logger.info(f"Display connected on {self.display.ser.port}")
+            self.last_io = time.time()
+        return self.display is not None
+
+    def disconnect(self):
+        if self.display:
+            try:
+                self.display.close()
+            except Exception:
+                pass
+        self.display = None
+
+    def execute(self, line):
+        """Send one command and return its OK/ERR reply; events are forwarded."""
+        if not self.connect():
+            return "ERR DISPLAY OFFLINE"
+        ser = self.display.ser
+        timeout = COMMIT_TIMEOUT if line.upper().startswith("ASSET COMMIT") else RESPONSE_TIMEOUT
+        try:
+            ser.write(f"{line}\n".encode('utf-8'))
+            if self.display.capture:
+                self.display.capture.record(line)
+            deadline = time.time() + timeout
+            while time.time() < deadline:
+                raw = ser.readline()
+                if not raw:
+                    continue
+                reply = raw.decode('utf-8', errors='ignore').strip()
+                if reply.startswith("OK") or reply.startswith("ERR"):
+                    self.last_io = time.time()
+                    return reply
+                self.forward(reply)
+            return "ERR TIMEOUT"
+        except Exception as e:
+            logger.error(f"Display I/O error: {e}")
+            self.disconnect()
+            return "ERR DISPLAY OFFLINE"
+
+    def drain(self):
+        """Forward unsolicited lines while idle, and keep the link checked."""
+        if not self.display:
+            self.connect()
+            return
+        try:
+            ser = self.display.ser
+            while ser.in_waiting:
+                self.forward(ser.readline().decode('utf-8', errors='ignore').strip())
+        except Exception as e:
+            logger.error(f"Display I/O error: {e}")
+            self.disconnect()
+            return
+        if time.time() - self.last_io > KEEPALIVE_INTERVAL:
+            self.execute("STATUS")
+
+    def worker(self):
+        if not self.connect():
+            logger.warning("Display not detected yet, will keep trying")
+        while self.running:
+            with self.cond:
+                if not self.queue:
+                    self.cond.wait(0.02)
+                req = None
+                if self.queue:
+                    req = max(self.queue, key=lambda r: (r.priority, -r.seq))
+                    self.queue.remove(req)
+            if req is None:
+                self.drain()
+                continue
+            reply = self.execute(req.line)
+            for client in req.waiters:
+                client.send_line(reply)
+
+    def forward(self, line):
+        """Events go to subscribers, log lines only to our own log."""
+        if line.startswith(EVENT_PREFIX):
+            self.broadcast(line)
+        elif line:
+            logger.debug(f"Display: {line}")
+
+    # --- client side ------------------------------------------------------
+    def broadcast(self, line):
+        for client in list(self.clients):
+            if client.subscribed:
+                client.send_line(line)
+
+    def submit(self, client, line):
+        if is_owned(line):
+            with self.cond:
+                owner = self.owner
+                if owner is not None and owner is not client and owner.priority > client.priority:
+                    client.send_line("ERR BUSY")
+                    return
+                self.owner = client
+
+        req = Request(client, line, client.priority)
+        with self.cond:
+            if req.key:
+                for queued in self.queue:
+                    if queued.key == req.key and req.priority >= queued.priority:
+                        # Only the latest wins; earlier senders get its reply.
+                        # It runs where the latest was sent, after anything
+                        # queued in between
+                        queued.line = req.line
+                        queued.priority = req.priority
+                        queued.seq = req.seq
+                        queued.waiters.append(client)
+                        return
+            self.queue.append(req)
+            self.cond.notify()
+
+    def remove_client(self, client):
+        self.clients.discard(client)
+        with self.cond:
+            if self.owner is client:
+                self.owner = None
+
+    def serve(self, path):
+        if os.path.exists(path):
+            os.unlink(path)
+        daemon = self
+
+        class Handler(socketserver.StreamRequestHandler):
+            def setup(self):
+                super().setup()
+                self.priority = PRIORITIES['DIAGNOSTICS']
+                self.subscribed = False
+                self.lock = threading.Lock()
+                daemon.clients.add(self)
+
+            def send_line(self, line):
+                try:
+                    with self.lock:
+                        self.wfile.write(f"{line}\n".encode('utf-8'))
+                        self.wfile.flush()
+                except OSError:
+                    pass
+
+            def handle(self):
+                for raw in self.rfile:
+                    line = raw.decode('utf-8', errors='ignore').strip()
+                    if not line:
+                        continue
+                    if line.startswith('@'):
+                        self.local_command(line[1:].upper().split())
+                    else:
+                        daemon.submit(self, line)
+
+            def local_command(self, parts):
+                if parts[:1] == ['PRIORITY'] and len(parts) == 2 and parts[1] in PRIORITIES:
+                    self.priority = PRIORITIES[parts[1]]
+                    self.send_line(f"OK PRIORITY={parts[1]}")
+                elif parts[:1] == ['SUBSCRIBE'] and len(parts) == 2 and parts[1] in ('ON', 'OFF'):
+                    self.subscribed = parts[1] == 'ON'
+                    self.send_line(f"OK SUBSCRIBE={parts[1]}")
+                elif parts == ['PING']:
+                    self.send_line("OK PONG")
+                else:
+                    self.send_line("ERR UNKNOWN DAEMON COMMAND")
+
+            def finish(self):
+                daemon.remove_client(self)
+                super().finish()
+
+        class Server(socketserver.ThreadingMixIn, socketserver.UnixStreamServer):
+            daemon_threads = True
+
+        # Bind before touching the serial port: opening it resets the ESP32
+        # (2 s), and clients started with us should find the socket, not fall
+        # back to the port. Until the display is up they get ERR DISPLAY OFFLINE.
+        server = Server(path, Handler)
+        os.chmod(path, 0o660)
+        logger.info(f"Display daemon listening on {path}")
+        sd_notify("READY=1")
+        threading.Thread(target=self.worker, daemon=True).start()
+        try:
+            server.serve_forever()
+        finally:
+            self.running = False
+            server.server_close()
+            os.unlink(path)
+            self.disconnect()
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Share the LED display between processes')
+    parser.add_argument('--port', help='Serial port (default: auto-detect)')
+    parser.add_argument('--socket', default=DAEMON_SOCKET, help=f'Unix socket path (default: {DAEMON_SOCKET})')
+    args = parser.parse_args()
+
+    logging.basicConfig(level=logging.INFO, format='%(asctime)s - %(levelname)s - %(message)s')
+    daemon = DisplayDaemon(args.port)
+    try:
+        daemon.serve(args.socket)
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == '__main__':
+    main()
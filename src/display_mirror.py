@@ -0,0 +1,79 @@
+"""
+Decoder for the display's framebuffer mirror (`MIRROR ON [hz]`).
+
+The firmware sends "!MF <seq> <op> <hex>" event lines carrying the XOR difference
+between the current framebuffer and the previous frame, optionally shifted
+to follow scrolling text. Wire format: display/hw/include/mirror.h.
+"""
+
+DISPLAY_WIDTH = 32
+DISPLAY_HEIGHT = 8
+
+
+class MirrorDecoder:
+    def __init__(self, width=DISPLAY_WIDTH):
+        self.width = width
+        self.columns = [0] * width   # LSB = top row
+        self.synced = False          # False until the first keyframe
+        self.seq = None
+        self.frames = 0
+        self.dropped = 0
+        self.bytes = 0
+
+    @staticmethod
+    def is_frame(line):
+        return line.startswith("!MF ")
+
+    def feed(self, line):
+        """
+        Apply one !MF line. Returns True if the frame changed the picture.
+        """
+        parts = line.strip().split(' ')
+        if len(parts) < 3 or parts[0] != "!MF":
+            return False
+        self.bytes += len(line) + 1
+
+        seq = int(parts[1])
+        op = parts[2]
+        payload = bytes.fromhex(parts[3]) if len(parts) > 3 else b''
+
+        if self.seq is not None and seq != (self.seq + 1) % 256:
+            self.dropped += 1
+            self.synced = False
+        self.seq = seq
+
+        if op == 'K':
+            ref = [0] * self.width
+            self.synced = True
+        elif not self.synced:
+            return False     # wait for the next keyframe
+        else:
+            shift = int(op)
+            ref = [self.columns[i + shift] if 0 <= i + shift < self.width else 0
+                   for i in range(self.width)]
+
+        i = 0
+        pos = 0
+        while pos < len(payload):
+            token = payload[pos]
+            pos += 1
+            if token < 0x80:
+                i += token + 1
+            else:
+                for _ in range(token - 0x7F):
+                    ref[i] ^= payload[pos]
+                    pos += 1
+                    i += 1
+
+        self.columns = ref
+        self.frames += 1
+        return True
+
+    def pixel(self, x, y):
+        return bool(self.columns[x] & (1 << y))
+
+    def render_ascii(self, on='#', off='.'):
+        return '\n'.join(
+            ''.join(on if self.pixel(x, y) else off for x in range(self.width))
+            for y in range(DISPLAY_HEIGHT)
+        )
@@ -0,0 +1,71 @@
+"""
+Decoder for the display's state snapshot (`STATE DUMP` / `STATE LOAD`).
+
+A snapshot is the hex payload of "OK STATE <hex>": pattern, text, scroll
+position, speed, brightness, snake and token progress, and the framebuffer,
+with a CRC-32 at the end. It is passed back unchanged to `STATE LOAD`; this
+module only reads it, so a reconnecting host can check what the display is
+doing. Wire format: the STATE SNAPSHOT section of display/hw/src/main.cpp.
+"""
+import struct
+import zlib
+
+STATE_VERSION = 1
+DISPLAY_WIDTH = 32
+TOKEN_COUNT = 6
+
+# Order of the firmware's Pattern enum
+PATTERNS = ('NONE', 'SNAKE', 'THINKING', 'FINISH', 'REMOVE_FIGURE', 'ERROR', 'TEXT',
+            'FAREWELL', 'SELFTEST', 'SPRITE', 'STRIP', 'PROGRESS6')
+SCROLL = (None, 'LEFT', 'RIGHT', 'LOOP')
+
+_HEADER = struct.Struct('<8B4hH14b6BHI')
+
+
+def decode(blob):
+    """
+    Parse a snapshot (bytes) into a dict. Raises ValueError if it is
+    truncated, corrupt or from another firmware version.
+    """
+    if len(blob) < _HEADER.size + DISPLAY_WIDTH + 1 + 4:
+        raise ValueError("state snapshot too short")
+    (crc,) = struct.unpack_from('<I', blob, len(blob) - 4)
+    if zlib.crc32(blob[:-4]) & 0xFFFFFFFF != crc:
+        raise ValueError("state snapshot CRC mismatch")
+
+    f = _HEADER.unpack_from(blob)
+    if f[0] != STATE_VERSION:
+        raise ValueError(f"state snapshot version {f[0]}, expected {STATE_VERSION}")
+    pos = _HEADER.size
+    frame = blob[pos:pos + DISPLAY_WIDTH]
+    pos += DISPLAY_WIDTH
+    text = blob[pos + 1:pos + 1 + blob[pos]].decode('latin-1')
+
+    snake = f[13:27]
+    progress = f[27:33]
+    return {
+        'pattern': PATTERNS[f[1]] if f[1] < len(PATTERNS) else f[1],
+        'scroll': SCROLL[f[2]] if f[2] < len(SCROLL) else f[2],
+        'brightness': f[3],
+        'speed': f[4],
+        'font': f[5],
+        'proportional': bool(f[6] & 1),
+        'stage': f[7],
+        'scroll_x': f[8],
+        'text_px': f[11],
+        'idle_ms': f[12],
+        'snake': [(snake[i], snake[i + 1]) for i in range(0, 10, 2)],
+        'food': (snake[10], snake[11]),
+        'tokens': [bool(p & 0x80) for p in progress],
+        'strip': (f[33], f[34]),          # width, CRC-32 of the loaded strip
+        'frame': frame,                   # columns, LSB = top row
+        'text': text,                     # TEXT message or sprite name
+    }
+
+
+def render_ascii(state, on='#', off='.'):
+    """The snapshot's framebuffer as '#'/'.' rows, for logs."""
+    return '\n'.join(
+        ''.join(on if c & (1 << y) else off for c in state['frame'])
+        for y in range(8)
+    )
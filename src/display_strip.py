@@ -0,0 +1,49 @@
+"""
+Renders text and images into bitmap strips for the display's STRIP command.
+
+A strip is one byte per column, LSB = top row, 8 rows high and up to
+STRIP_MAX_COLUMNS wide (display/hw/include/strip.h). Rendering on the host
+lets the display show umlauts, lowercase and any TrueType font or icon
+without the glyphs being in the firmware. Needs Pillow.
+"""
+STRIP_MAX_COLUMNS = 2048
+STRIP_HEIGHT = 8
+
+
+def image_to_strip(img, threshold=128):
+    """Convert a PIL image (cropped/padded to 8 rows) into column bytes."""
+    img = img.convert('L')
+    px = img.load()
+    rows = min(img.height, STRIP_HEIGHT)
+    cols = bytearray()
+    for x in range(min(img.width, STRIP_MAX_COLUMNS)):
+        col = 0
+        for y in range(rows):
+            if px[x, y] >= threshold:
+                col |= 1 << y
+        cols.append(col)
+    return bytes(cols)
+
+
+def render_text(text, font=None, size=8, spacing=1, threshold=128):
+    """
+    Render `text` in a TrueType/OpenType font (path) or Pillow's built-in
+    bitmap font, vertically centred on the 8 rows and trimmed left and right.
+    """
+    from PIL import Image, ImageDraw, ImageFont
+
+    face = ImageFont.truetype(font, size) if font else ImageFont.load_default()
+    left, top, right, bottom = face.getbbox(text)
+    width = max(1, right - left + spacing)
+    img = Image.new('L', (width, STRIP_HEIGHT), 0)
+    y = (STRIP_HEIGHT - (bottom - top)) // 2 - top
+    ImageDraw.Draw(img).text((-left, y), text, font=face, fill=255)
+    return image_to_strip(img, threshold)
+
+
+def render_ascii(columns):
+    """Strip as '#'/'.' rows, for logs and tests."""
+    return "\n".join(
+        "".join('#' if c & (1 << y) else '.' for c in columns)
+        for y in range(STRIP_HEIGHT)
+    )
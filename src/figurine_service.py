@@ -13,7 +13,8 @@ import socket
 
 from temperature_service import log_temperatures
 from rfid_controller import auto_detect_rfid
-from display_controller import auto_detect_display
+from display_controller import connect_display
+import display_state
 from printer_controller import auto_detect_printer, PrinterController
 
 
@@ -76,6 +77,23 @@ def get_wifi_ssid():
     except (subprocess.TimeoutExpired, FileNotFoundError):
         return "Unknown"
 
+def display_idle(display):
+    """
+    True if the display already shows the idle SNAKE at brightness 2, e.g.
+    after the service restarted, so it can be left running without a visible
+    restart.
+    """
+    blob = display.dump_state()
+    if not blob:
+        return False
+    try:
+        state = display_state.decode(blob)
+    except ValueError as e:
+        logger.warning(f"Display state unreadable: {e}")
+        return False
+    return state['pattern'] == 'SNAKE' and state['brightness'] == 2
+
+
 def main():
     # Parse command line arguments
     parser = argparse.ArgumentParser(description='Figurine Service')
@@ -91,7 +109,7 @@ def main():
     logger.info("Detecting devices...")
     
     # Display
-    display = auto_detect_display()
+    display = connect_display(priority="SERVICE")
     if display:
         logger.info("✓ Display detected")
     else:
@@ -157,7 +175,7 @@ def main():
         while True:
             # State: SNAKE / SCANNING
             logger.info("State: SNAKE (Scanning for 6 tags)")
-            if display:
+            if display and not display_idle(display):
                 display.set_brightness(2)
                 display.set_pattern("SNAKE")
             
@@ -172,7 +190,10 @@ def main():
                 time.sleep(0.5)
                 
             try:
-                tags_list = rfid.read_tags(target_tags=6, max_attempts=240, use_anti_collision=True)
+                # Light one PROGRESS6 segment per token as soon as it is read
+                on_new_tag = (lambda count, tag: display.set_token(count)) if display else None
+                tags_list = rfid.read_tags(target_tags=6, max_attempts=240, use_anti_collision=True,
+                                           on_new_tag=on_new_tag)
             except Exception as e:
                 logger.error(f"Error during tag reading: {e}")
                 continue
@@ -182,10 +203,10 @@ def main():
             logger.info("State: THINKING (Processing tags)")
             if display:
                 display.set_brightness(10)
-                display.set_text("HI")
+                display.set_text("HI", direction="FIT")
                 time.sleep(2)
                 display.set_brightness(6)
-                display.set_text("THINKING", direction="LEFT")
+                display.set_text("THINKING", direction="FIT")
             
             answers = data_service.find_answer_by_tags([tag['epc'] for tag in tags_list])
             
@@ -254,7 +275,7 @@ def main():
                     logger.info("Printing slip...")
                     if display:
                         display.set_speed(10)
-                        display.set_text("VOILA")
+                        display.set_text("VOILA", direction="FIT")
                     
                     create_full_receipt(printer.printer, slip_data)
                     logger.info("Receipt printed successfully.")
@@ -270,7 +291,7 @@ def main():
             logger.info("State: FINISH (Waiting 20s)")
             if display:
                 display.set_speed(7)
-                display.set_text("THANK YOU!", direction="LEFT")
+                display.set_text("THANK YOU!", direction="FIT")
             time.sleep(5)
             
             # Ensure tags are removed before restarting cycle
@@ -278,7 +299,7 @@ def main():
             if rfid.has_tags_present():
                 if display:
                     display.set_speed(7)
-                    display.set_text("REMOVE FIGURE", direction="LEFT")
+                    display.set_text("REMOVE FIGURE", direction="FIT")
                 logger.info("Tags detected after finish; waiting for removal...")
                 time.sleep(0.5)
                 
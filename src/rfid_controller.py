@@ -170,7 +170,7 @@ class M5StackUHF:
         self._send_command(cmd)
         return self._wait_response(timeout=0.3)
     
-    def read_tags(self, target_tags=6, max_attempts=20, use_anti_collision=False):
+    def read_tags(self, target_tags=6, max_attempts=20, use_anti_collision=False, on_new_tag=None):
         """
         Read RFID tags using optimized single_power_26dbm strategy.
         
@@ -178,6 +178,7 @@ class M5StackUHF:
             target_tags: Number of unique tags to find (default: 6)
             max_attempts: Maximum polling attempts (default: 20)
             use_anti_collision: If True, silence tags after reading to detect weaker tags (default: False)
+            on_new_tag: Called as on_new_tag(count, tag) as soon as each new tag is found
             
         Returns:
             List of tag dictionaries with 'epc', 'rssi', 'pc' fields
@@ -203,6 +204,8 @@ class M5StackUHF:
                     unique_tags[epc] = tag
                     logger.info(f"Found tag {epc} (RSSI: {tag['rssi']}) - {len(unique_tags)}/{target_tags}")
                     new_tags_found = True
+                    if on_new_tag:
+                        on_new_tag(len(unique_tags), tag)
                     
                     # Silence this tag so we can hear others
                     if use_anti_collision:
@@ -29,6 +29,7 @@ fi
 # Copy service file to systemd
 echo "Installing systemd service..."
 sudo cp /home/fi/unfinished-figurine/figurine.service /etc/systemd/system/
+sudo cp /home/fi/unfinished-figurine/figurine-display.service /etc/systemd/system/
 
 # Reload systemd
 echo "Reloading systemd daemon..."
@@ -36,6 +37,7 @@ sudo systemctl daemon-reload
 
 # Enable service to start on boot
 echo "Enabling service to start on boot..."
+sudo systemctl enable figurine-display.service
 sudo systemctl enable figurine.service
 
 echo ""